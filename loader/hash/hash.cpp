@@ -35,6 +35,35 @@ std::string calculateHash(std::string_view data) {
     return calculateHash(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(data.data()), data.size()));
 }
 
+void IncrementalHash::Deleter::operator()(evp_md_ctx_st* ctx) const {
+    EVP_MD_CTX_free(ctx);
+}
+
+IncrementalHash::IncrementalHash() : m_context(EVP_MD_CTX_new()) {
+    if (m_context && EVP_DigestInit_ex(m_context.get(), EVP_sha256(), nullptr) != 1) {
+        m_context.reset();
+    }
+}
+
+IncrementalHash::~IncrementalHash() = default;
+
+void IncrementalHash::update(std::span<const uint8_t> data) {
+    if (m_context && EVP_DigestUpdate(m_context.get(), data.data(), data.size()) != 1) {
+        m_context.reset();
+    }
+}
+
+std::string IncrementalHash::finish() {
+    if (!m_context) {
+        return "";
+    }
+    uint8_t hash[SHA256_DIGEST_LENGTH];
+    unsigned int hashLen = 0;
+    auto ok = EVP_DigestFinal_ex(m_context.get(), hash, &hashLen) == 1;
+    m_context.reset();
+    return ok ? hexEncode(hash, hashLen) : "";
+}
+
 static Result<std::string> computeWithReader(auto&& fn) {
     auto context = std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)>(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
     if (!context) {
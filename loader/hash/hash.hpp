@@ -2,8 +2,11 @@
 
 #include <string>
 #include <filesystem>
+#include <memory>
 #include <span>
 
+struct evp_md_ctx_st;
+
 std::string calculateSHA256(std::filesystem::path const& path);
 
 std::string calculateSHA256Text(std::filesystem::path const& path);
@@ -14,3 +17,26 @@ std::string calculateSHA256Text(std::filesystem::path const& path);
  */
 std::string calculateHash(std::span<const uint8_t> data);
 std::string calculateHash(std::string_view data);
+
+/**
+ * Calculates the same hash as calculateHash, but over data that
+ * arrives in pieces
+ */
+class IncrementalHash final {
+public:
+    IncrementalHash();
+    ~IncrementalHash();
+
+    IncrementalHash(IncrementalHash const&) = delete;
+    IncrementalHash& operator=(IncrementalHash const&) = delete;
+
+    void update(std::span<const uint8_t> data);
+    /// Returns an empty string if hashing failed at any point
+    std::string finish();
+
+private:
+    struct Deleter {
+        void operator()(evp_md_ctx_st* ctx) const;
+    };
+    std::unique_ptr<evp_md_ctx_st, Deleter> m_context;
+};
@@ -82,6 +82,11 @@ namespace geode::dirs {
      * `getGeodeDir()`/index
      */
     GEODE_DLL std::filesystem::path getIndexDir();
+    /**
+     * Directory where Geode caches downloaded data, like web responses
+     * `getGeodeDir()`/cache
+     */
+    GEODE_DLL std::filesystem::path getCacheDir();
     /**
      * Directory where crashlogs are stored
      * `getGeodeDir()`/crashlogs
@@ -64,22 +64,59 @@ namespace geode::comm {
         }
     };
 
-    template <class Callable>
-    struct PortCallableMove : PortCallableCopy<Callable> {
-        template <class ...Args>
-        bool call(Args&&... args) noexcept(std::is_nothrow_invocable_v<Callable, Args...>) {
-            if (!this->m_callable) return false;
+    class EventCenterThreadLocal;
+    class EventCenterGlobal;
 
-            if constexpr (std::is_same_v<void, decltype(std::invoke(this->m_callable, std::forward<Args>(args)...))>) {
-                std::invoke(std::move(this->m_callable), std::forward<Args>(args)...);
-                return false;
+    // A compiled, priority-ordered view of a port's receivers. Sends walk this
+    // array directly instead of checking pending removals for every receiver.
+    // It points into the port's own receiver list, which never changes while a
+    // send is in flight, so callables are shared rather than copied. The table is
+    // frozen while a send is in flight; removals made during it only flip the
+    // receiver's tombstone, and the next outermost send recompiles it.
+    template <class Callable, template <class> class Container, bool ThreadSafe>
+    struct PortDispatchTable {
+        using FlagType = std::conditional_t<ThreadSafe, std::atomic_bool, bool>;
+
+        std::vector<Container<Callable>*> m_receivers;
+        std::unique_ptr<FlagType[]> m_removed;
+        size_t m_removedCapacity = 0;
+        // the port state this table was compiled from, used to detect receivers
+        // added or removed by code compiled against an older version of Port
+        size_t m_nextID = 0;
+        size_t m_size = 0;
+
+        // Refills the table from a receiver list, skipping the ones `skip` returns
+        // true for. Recompiling an existing table only allocates if the port grew
+        template <class Receivers, class Skip>
+        void compile(Receivers& receivers, Skip&& skip, size_t nextID) noexcept {
+            m_receivers.clear();
+            m_receivers.reserve(receivers.size());
+            for (auto it = receivers.begin(); it != receivers.end(); ++it) {
+                if (skip(it)) continue;
+                m_receivers.push_back(&*it);
+            }
+            if (m_removedCapacity < m_receivers.size()) {
+                m_removedCapacity = m_receivers.capacity();
+                m_removed = std::make_unique<FlagType[]>(m_removedCapacity);
+            }
+            else {
+                for (size_t i = 0; i < m_receivers.size(); ++i) {
+                    m_removed[i] = false;
+                }
             }
-            return std::invoke(std::move(this->m_callable), std::forward<Args>(args)...);
+            m_nextID = nextID;
+            m_size = receivers.size();
         }
-    };
 
-    class EventCenterThreadLocal;
-    class EventCenterGlobal;
+        void markRemoved(ReceiverHandle handle) noexcept {
+            for (size_t i = 0; i < m_receivers.size(); ++i) {
+                if (m_receivers[i]->m_handle == handle) {
+                    m_removed[i] = true;
+                    return;
+                }
+            }
+        }
+    };
 
     // Okay so even though the Event system is fully header only,
     // we can still version it. One caveat/hackiness is that
@@ -91,11 +128,62 @@ namespace geode::comm {
     template <class Callable, bool ThreadSafe=false, template <class> class Container = PortCallableCopy>
     class Port {
     protected:
+        using DispatchTable = PortDispatchTable<Callable, Container, false>;
+
         std::vector<Container<Callable>> m_receivers;
         std::vector<typename std::vector<Container<Callable>>::iterator> m_toRemove;
         std::vector<Container<Callable>> m_toAdd;
         size_t m_nextID = 1;
         size_t m_sending = 0;
+        // V4
+        std::shared_ptr<DispatchTable> m_dispatch;
+        size_t m_dispatchRemovals = 0;
+        size_t m_dispatching = 0;
+
+        void insertSorted(Container<Callable>&& receiver) noexcept {
+            auto it = std::upper_bound(m_receivers.begin(), m_receivers.end(), receiver.m_priority, [](int priority, auto const& other) {
+                return priority < other.m_priority;
+            });
+            m_receivers.insert(it, std::move(receiver));
+        }
+
+        bool isDispatchStale() const noexcept {
+            return !m_dispatch || m_dispatch->m_nextID != m_nextID || m_dispatch->m_size != m_receivers.size();
+        }
+
+        void compileDispatch() noexcept {
+            // an in-flight send may still be walking the old table
+            if (!m_dispatch || m_dispatch.use_count() > 1) {
+                m_dispatch = std::make_shared<DispatchTable>();
+            }
+            m_dispatch->compile(m_receivers, [this](auto it) {
+                // only non-empty if an older version's send is in flight
+                return std::find(m_toRemove.begin(), m_toRemove.end(), it) != m_toRemove.end();
+            }, m_nextID);
+            m_dispatchRemovals = m_toRemove.size();
+        }
+
+        void syncDispatchRemovals() noexcept {
+            for (; m_dispatchRemovals < m_toRemove.size(); ++m_dispatchRemovals) {
+                m_dispatch->markRemoved(m_toRemove[m_dispatchRemovals]->m_handle);
+            }
+        }
+
+        void flushPending() noexcept {
+            if (!m_toRemove.empty()) {
+                std::sort(m_toRemove.rbegin(), m_toRemove.rend());
+                for (auto& it : m_toRemove) {
+                    m_receivers.erase(it);
+                }
+                m_toRemove.clear();
+            }
+            for (auto& receiver : m_toAdd) {
+                this->insertSorted(std::move(receiver));
+            }
+            m_toAdd.clear();
+            m_dispatchRemovals = 0;
+        }
+
     public:
         using CallableType = Callable;
         using EventCenterType = EventCenterThreadLocal;
@@ -119,41 +207,41 @@ namespace geode::comm {
             other.m_sending = 0;
         }
 
+        // V3 ports have the same members as V2, but they end before m_dispatch
+        // so it must not be touched on the old port
+        void migrateFromV3(Port&& other) noexcept {
+            this->migrateFromV2(std::move(other));
+        }
+
         ReceiverHandle addReceiver(Callable receiver, int priority = 0) noexcept {
             ReceiverHandle handle = static_cast<ReceiverHandle>(m_nextID++);
             if (m_sending > 0) {
-                // geode::console::log(fmt::format("Added handler with id {} to toAdd", handle), Severity::Debug);
                 m_toAdd.push_back({std::move(receiver), priority, handle});
                 return handle;
             }
-            for (auto it = m_receivers.begin(); it != m_receivers.end(); ++it) {
-                if (priority < it->m_priority) {
-                    // geode::console::log(fmt::format("Added handler with id {} to receivers", handle), Severity::Debug);
-                    m_receivers.insert(it, {std::move(receiver), priority, handle});
-                    return handle;
-                }
-            }
-            m_receivers.push_back({std::move(receiver), priority, handle});
+            this->insertSorted({std::move(receiver), priority, handle});
             return handle;
         }
 
         size_t removeReceiver(ReceiverHandle handle) noexcept {
-            auto size = m_receivers.size();
-            for (int i = 0; i < size; ++i) {
-                if (m_receivers[i].m_handle == handle) {
-                    if (m_sending > 0) {
-                        // geode::console::log(fmt::format("Added handler with id {} to toRemove", handle), Severity::Debug);
-                        m_toRemove.push_back(m_receivers.begin() + i);
-                    } else {
-                        // geode::console::log(fmt::format("Removed handler with id {} from receivers", handle), Severity::Debug);
-                        m_receivers.erase(m_receivers.begin() + i);
-                    }
-                    // size - 1, return for symmetry
-                    return size - 1;
+            auto it = std::find_if(m_receivers.begin(), m_receivers.end(), [handle](auto const& receiver) {
+                return receiver.m_handle == handle;
+            });
+            if (it != m_receivers.end()) {
+                if (m_sending == 0) {
+                    m_receivers.erase(it);
                 }
+                else if (std::find(m_toRemove.begin(), m_toRemove.end(), it) == m_toRemove.end()) {
+                    m_toRemove.push_back(it);
+                }
+            }
+            else {
+                // added and removed during the same send
+                std::erase_if(m_toAdd, [handle](auto const& receiver) {
+                    return receiver.m_handle == handle;
+                });
             }
-            // size
-            return size;
+            return this->getReceiverCount();
         }
 
         size_t getReceiverCount() const noexcept {
@@ -163,36 +251,32 @@ namespace geode::comm {
         template <class ...Args>
         requires std::invocable<Callable, Args...>
         bool send(Args&&... value) noexcept(std::is_nothrow_invocable_v<Callable, Args...>) {
+            // Nested sends reuse the outer table. If only an older version's send
+            // is in flight, we can't tell what changed, so just recompile.
+            if (m_dispatching == 0 && (m_sending > 0 || this->isDispatchStale())) {
+                this->compileDispatch();
+            }
+
+            auto table = m_dispatch;
             m_sending++;
+            m_dispatching++;
             bool ret = false;
-            for (auto& callable : m_receivers) {
-                if (std::find_if(m_toRemove.begin(), m_toRemove.end(), [&callable](auto& it) {
-                    return it->m_handle == callable.m_handle;
-                }) != m_toRemove.end()) {
-                    // geode::console::log(fmt::format("Skipping handler with id {} because it is in toRemove", callable.m_handle), Severity::Debug);
-                    continue;
+            auto const count = table->m_receivers.size();
+            for (size_t i = 0; i < count; ++i) {
+                if (m_dispatchRemovals != m_toRemove.size()) {
+                    this->syncDispatchRemovals();
                 }
-                if (callable.call(value...)) {
+                if (table->m_removed[i]) continue;
+                if (table->m_receivers[i]->call(value...)) {
                     ret = true;
                     break;
                 }
             }
+            m_dispatching--;
             m_sending--;
 
             if (m_sending == 0) {
-                // geode::console::log(fmt::format("Flushing {} handlers from toRemove", m_toRemove.size()), Severity::Debug);
-                std::sort(m_toRemove.rbegin(), m_toRemove.rend());
-                for (auto& it : m_toRemove) {
-                    m_receivers.erase(it);
-                }
-                m_toRemove.clear();
-
-                // geode::console::log(fmt::format("Flushing {} handlers from toAdd", m_toAdd.size()), Severity::Debug);
-                m_receivers.insert(m_receivers.end(), std::make_move_iterator(m_toAdd.begin()), std::make_move_iterator(m_toAdd.end()));
-                m_toAdd.clear();
-                std::sort(m_receivers.begin(), m_receivers.end(), [](auto& a, auto& b) {
-                    return a.m_priority < b.m_priority;
-                });
+                this->flushPending();
             }
 
             return ret;
@@ -202,6 +286,7 @@ namespace geode::comm {
     template <class Callable, template <class> class Container>
     class Port<Callable, true, Container>  {
         using VectorType = std::vector<Container<Callable>>;
+        using DispatchTable = PortDispatchTable<Callable, Container, true>;
         // we should have just used a atomic shared ptr!
         asp::PtrSwap<VectorType> m_receivers;
         mutable std::mutex m_mutex;
@@ -209,6 +294,49 @@ namespace geode::comm {
         std::vector<Container<Callable>> m_toAdd;
         size_t m_nextID = 1;
         size_t m_sending = 0;
+        // V4
+        std::shared_ptr<DispatchTable> m_dispatch;
+        size_t m_dispatching = 0;
+
+        void insertSorted(VectorType& receivers, Container<Callable>&& receiver) noexcept {
+            auto it = std::upper_bound(receivers.begin(), receivers.end(), receiver.m_priority, [](int priority, auto const& other) {
+                return priority < other.m_priority;
+            });
+            receivers.insert(it, std::move(receiver));
+        }
+
+        // must be called with m_mutex held
+        bool isDispatchStale(VectorType const& receivers) const noexcept {
+            return !m_dispatch || m_dispatch->m_nextID != m_nextID || m_dispatch->m_size != receivers.size();
+        }
+
+        // must be called with m_mutex held
+        void compileDispatch(VectorType& receivers) noexcept {
+            // sends on other threads may still be walking the old table
+            if (!m_dispatch || m_dispatch.use_count() > 1) {
+                m_dispatch = std::make_shared<DispatchTable>();
+            }
+            m_dispatch->compile(receivers, [this](auto it) {
+                return std::find(m_toRemove.begin(), m_toRemove.end(), it) != m_toRemove.end();
+            }, m_nextID);
+        }
+
+        // must be called with m_mutex held
+        void flushPending() noexcept {
+            auto receivers = m_receivers.load();
+            if (!m_toRemove.empty()) {
+                std::sort(m_toRemove.rbegin(), m_toRemove.rend());
+                for (auto& it : m_toRemove) {
+                    receivers->erase(it);
+                }
+                m_toRemove.clear();
+            }
+            for (auto& receiver : m_toAdd) {
+                this->insertSorted(*receivers, std::move(receiver));
+            }
+            m_toAdd.clear();
+        }
+
     public:
         using CallableType = Callable;
         using EventCenterType = EventCenterGlobal;
@@ -223,45 +351,51 @@ namespace geode::comm {
             m_receivers.store(other.m_receivers.load());
         }
 
+        // V3 ports end before m_dispatch, so it must not be touched on the old port
+        void migrateFromV3(Port&& other) noexcept {
+            auto lock = std::unique_lock<std::mutex>(other.m_mutex);
+            m_receivers.store(other.m_receivers.load());
+            m_toRemove = std::move(other.m_toRemove);
+            m_toAdd = std::move(other.m_toAdd);
+            m_nextID = other.m_nextID;
+            m_sending = other.m_sending;
+        }
+
         ReceiverHandle addReceiver(Callable receiver, int priority = 0) noexcept {
             auto lock = std::unique_lock<std::mutex>(m_mutex);
             ReceiverHandle handle = static_cast<ReceiverHandle>(m_nextID++);
-            auto receivers = m_receivers.load();
             if (m_sending > 0) {
-                // geode::console::log(fmt::format("Added handler with id {} to toAdd", handle), Severity::Debug);
                 m_toAdd.push_back({std::move(receiver), priority, handle});
                 return handle;
             }
-            for (auto it = receivers->begin(); it != receivers->end(); ++it) {
-                if (priority < it->m_priority) {
-                    // geode::console::log(fmt::format("Added handler with id {} to receivers", handle), Severity::Debug);
-                    receivers->insert(it, {std::move(receiver), priority, handle});
-                    return handle;
-                }
-            }
-            receivers->push_back({std::move(receiver), priority, handle});
+            this->insertSorted(*m_receivers.load(), {std::move(receiver), priority, handle});
             return handle;
         }
 
         size_t removeReceiver(ReceiverHandle handle) noexcept {
             auto lock = std::unique_lock<std::mutex>(m_mutex);
             auto receivers = m_receivers.load();
-            auto size = receivers->size();
-            for (int i = 0; i < size; ++i) {
-                if ((*receivers)[i].m_handle == handle) {
-                    if (m_sending > 0) {
-                        // geode::console::log(fmt::format("Added handler with id {} to toRemove", handle), Severity::Debug);
-                        m_toRemove.push_back(receivers->begin() + i);
-                    } else {
-                        // geode::console::log(fmt::format("Removed handler with id {} from receivers", handle), Severity::Debug);
-                        receivers->erase(receivers->begin() + i);
+            auto it = std::find_if(receivers->begin(), receivers->end(), [handle](auto const& receiver) {
+                return receiver.m_handle == handle;
+            });
+            if (it != receivers->end()) {
+                if (m_sending == 0) {
+                    receivers->erase(it);
+                }
+                else if (std::find(m_toRemove.begin(), m_toRemove.end(), it) == m_toRemove.end()) {
+                    m_toRemove.push_back(it);
+                    // sends on other threads only look at the tombstones
+                    if (m_dispatching > 0) {
+                        m_dispatch->markRemoved(handle);
                     }
-                    // size - 1, return for symmetry
-                    return size - 1;
                 }
             }
-            // size
-            return size;
+            else {
+                std::erase_if(m_toAdd, [handle](auto const& receiver) {
+                    return receiver.m_handle == handle;
+                });
+            }
+            return receivers->size() + m_toAdd.size() - m_toRemove.size();
         }
 
         size_t getReceiverCount() const noexcept {
@@ -273,40 +407,32 @@ namespace geode::comm {
         requires std::invocable<Callable, Args...>
         bool send(Args&&... value) noexcept(std::is_nothrow_invocable_v<Callable, Args...>) {
             auto lock = std::unique_lock<std::mutex>(m_mutex);
-
+            if (m_dispatching == 0) {
+                auto receivers = m_receivers.load();
+                if (m_sending > 0 || this->isDispatchStale(*receivers)) {
+                    this->compileDispatch(*receivers);
+                }
+            }
+            auto table = m_dispatch;
             m_sending++;
+            m_dispatching++;
+            lock.unlock();
+
             bool ret = false;
-            auto receivers = m_receivers.load();
-            for (auto& callable : *receivers) {
-                if (std::find_if(m_toRemove.begin(), m_toRemove.end(), [&callable](auto& it) {
-                    return it->m_handle == callable.m_handle;
-                }) != m_toRemove.end()) {
-                    // geode::console::log(fmt::format("Skipping handler with id {} because it is in toRemove", callable.m_handle), Severity::Debug);
-                    continue;
-                }
-                lock.unlock();
-                if (callable.call(value...)) {
+            auto const count = table->m_receivers.size();
+            for (size_t i = 0; i < count; ++i) {
+                if (table->m_removed[i].load(std::memory_order_acquire)) continue;
+                if (table->m_receivers[i]->call(value...)) {
                     ret = true;
-                    lock.lock();
                     break;
                 }
-                lock.lock();
             }
-            m_sending--;
 
+            lock.lock();
+            m_dispatching--;
+            m_sending--;
             if (m_sending == 0) {
-                auto receivers = m_receivers.load();
-                std::sort(m_toRemove.rbegin(), m_toRemove.rend());
-                for (auto& it : m_toRemove) {
-                    receivers->erase(it);
-                }
-                m_toRemove.clear();
-
-                receivers->insert(receivers->end(), std::make_move_iterator(m_toAdd.begin()), std::make_move_iterator(m_toAdd.end()));
-                m_toAdd.clear();
-                std::sort(receivers->begin(), receivers->end(), [](auto& a, auto& b) {
-                    return a.m_priority < b.m_priority;
-                });
+                this->flushPending();
             }
 
             return ret;
@@ -443,6 +569,10 @@ namespace geode::comm {
     requires PortTemplateFor<PortTemplate, geode::CopyableFunction<bool(PArgs...)>>
     class OpaqueEventPortV3;
 
+    template <template <class> class PortTemplate, class... PArgs>
+    requires PortTemplateFor<PortTemplate, geode::CopyableFunction<bool(PArgs...)>>
+    class OpaqueEventPortV4;
+
     // In order to version Ports, we need to make a new EventPort class for every version,
     // and subclass the previous one. For example a V3 would subclass V2, which subclasses V1.
     // This is because we dont have a virtual version check function (i forgot) wait actually
@@ -480,6 +610,7 @@ namespace geode::comm {
 
         friend class OpaqueEventPortV2<PortTemplate, PArgs...>;
         friend class OpaqueEventPortV3<PortTemplate, PArgs...>;
+        friend class OpaqueEventPortV4<PortTemplate, PArgs...>;
     };
 
     template <template <class> class PortTemplate, class... PArgs>
@@ -506,6 +637,23 @@ namespace geode::comm {
         }
     };
 
+    // Lets the event centers recognize V4 ports without knowing their template
+    // arguments, so sending to one doesn't have to check whether it needs migrating
+    class OpaquePortV4Tag {};
+
+    // V4 ports dispatch through a compiled PortDispatchTable
+    template <template <class> class PortTemplate, class... PArgs>
+    requires PortTemplateFor<PortTemplate, geode::CopyableFunction<bool(PArgs...)>>
+    class OpaqueEventPortV4 : public OpaqueEventPortV3<PortTemplate, PArgs...>, public OpaquePortV4Tag {
+    public:
+        OpaqueEventPortV4() {}
+        ~OpaqueEventPortV4() noexcept override {}
+
+        void migrateFromV3(OpaqueEventPortV3<PortTemplate, PArgs...>* oldPort) noexcept {
+            this->m_port.migrateFromV3(std::move(oldPort->m_port));
+        }
+    };
+
     class BaseFilter {
     public:
         virtual ~BaseFilter() noexcept = default;
@@ -544,6 +692,14 @@ namespace geode::comm {
         using is_transparent = void;
     };
 
+    // Counts the live ports of every event type across all event centers, so hot
+    // emitters can skip building and sending an event that nobody listens to
+    class GEODE_DLL EventInterest {
+    public:
+        // The returned counter lives forever, callers are expected to cache it
+        static std::atomic_size_t const& get(std::type_info const& type) noexcept;
+    };
+
     template<class Marker, template <class> class PortTemplate, class Func, class... FArgs>
     class BasicEvent {
     private:
@@ -639,28 +795,37 @@ namespace geode::comm {
         using OpaqueEventType = OpaqueEventPort<PortTemplate, PArgs...>;
         using OpaqueEventV2Type = OpaqueEventPortV2<PortTemplate, PArgs...>;
         using OpaqueEventV3Type = OpaqueEventPortV3<PortTemplate, PArgs...>;
-        using LatestOpaqueEventType = OpaqueEventV3Type;
+        using OpaqueEventV4Type = OpaqueEventPortV4<PortTemplate, PArgs...>;
+        using LatestOpaqueEventType = OpaqueEventV4Type;
         using EventCenterType = LatestOpaqueEventType::EventCenterType;
 
         // Here we migrate the port version if needed. This is what I meant by versioning,
         // we need to check for previous versions and move them into the current version.
         // Go to getPort definition.
         static OpaquePortBase* migratePort(OpaquePortBase* port) {
-            // handles V1->V3
+            // handles V1->V4
             if (!geode::cast::typeinfo_cast<OpaqueEventV2Type*>(port)) {
                 auto oldPort = static_cast<OpaqueEventType*>(port);
-                auto newPort = new OpaqueEventV3Type();
+                auto newPort = new OpaqueEventV4Type();
                 newPort->migrateFromV1(oldPort);
                 return newPort;
             }
 
-            // handles V2->V3
+            // handles V2->V4
             if (!geode::cast::typeinfo_cast<OpaqueEventV3Type*>(port)) {
                 auto oldPort = static_cast<OpaqueEventV2Type*>(port);
-                auto newPort = new OpaqueEventV3Type();
+                auto newPort = new OpaqueEventV4Type();
                 newPort->migrateFromV2(oldPort);
                 return newPort;
             }
+
+            // handles V3->V4
+            if (!geode::cast::typeinfo_cast<OpaqueEventV4Type*>(port)) {
+                auto oldPort = static_cast<OpaqueEventV3Type*>(port);
+                auto newPort = new OpaqueEventV4Type();
+                newPort->migrateFromV3(oldPort);
+                return newPort;
+            }
             return nullptr;
         }
 
@@ -688,7 +853,7 @@ namespace geode::comm {
         // All of the normal functions do static cast version, but that is not strictly needed,
         // what is needed however is updating this getPort function.
         OpaquePortBase* getPort() const noexcept override {
-            return new (std::nothrow) OpaqueEventV3Type();
+            return new (std::nothrow) OpaqueEventV4Type();
         }
 
         size_t hash() const noexcept override {
@@ -727,6 +892,13 @@ namespace geode::comm {
 
         size_t getReceiverCount() const noexcept;
 
+        /// Returns false if nothing listens to this event type with any filter,
+        /// which is cheap enough to check before constructing the event on hot paths
+        static bool hasListeners() noexcept {
+            static auto& s_interest = EventInterest::get(typeid(Self));
+            return s_interest.load(std::memory_order_relaxed) != 0;
+        }
+
         template<class Callable>
         ListenerHandle listen(Callable listener, int priority = 0) const noexcept {
             if constexpr (std::is_convertible_v<std::invoke_result_t<Callable, PArgs...>, bool>) {
@@ -747,6 +919,13 @@ namespace geode::comm {
         }
     };
 
+    // Every thread has its own EventCenterThreadLocal, so non thread safe events
+    // only reach listeners that were registered on the thread they are sent from.
+    // Use ThreadSafeEvent (or queue the send onto the listener's thread) if an event
+    // needs to cross threads. Debug builds warn when a send reaches nobody but another
+    // thread has listeners for it. A listener removed from another thread (for example
+    // by destroying its ListenerHandle there) is handed over to the thread that
+    // registered it, and is removed the next time that thread touches its events.
     class GEODE_DLL EventCenterThreadLocal {
     private:
         class Impl;
@@ -768,6 +947,9 @@ namespace geode::comm {
         ListenerHandle addReceiver(BaseFilter const* filter, AddFuncType func, MigrateFuncType migratePort) noexcept;
         size_t getReceiverCount(BaseFilter const* filter, SizeFuncType func, MigrateFuncType migratePort) noexcept;
         size_t removeReceiver(BaseFilter const* filter, RemoveFuncType func, MigrateFuncType migratePort) noexcept;
+        // Same as removeReceiver, but func may be run later on the thread that owns
+        // the listener, so it must not capture anything by reference
+        size_t removeReceiverV2(BaseFilter const* filter, RemoveFuncType func, MigrateFuncType migratePort) noexcept;
     };
 
     class GEODE_DLL EventCenterGlobal {
@@ -791,6 +973,7 @@ namespace geode::comm {
         ListenerHandle addReceiver(BaseFilter const* filter, AddFuncType func, MigrateFuncType migratePort) noexcept;
         size_t getReceiverCount(BaseFilter const* filter, SizeFuncType func, MigrateFuncType migratePort) noexcept;
         size_t removeReceiver(BaseFilter const* filter, RemoveFuncType func, MigrateFuncType migratePort) noexcept;
+        size_t removeReceiverV2(BaseFilter const* filter, RemoveFuncType func, MigrateFuncType migratePort) noexcept;
     };
 
     class EventCenter {
@@ -946,7 +1129,7 @@ namespace geode::comm {
         std::is_convertible_v<PReturn, bool> || std::is_same_v<PReturn, void>;
     }
     size_t BasicEvent<Marker, PortTemplate, PReturn(PArgs...), FArgs...>::removeReceiver(ReceiverHandle handle) const noexcept {
-        return EventCenterType::get()->removeReceiver(this, [&](OpaquePortBase* opaquePort) {
+        return EventCenterType::get()->removeReceiverV2(this, [handle](OpaquePortBase* opaquePort) {
             auto port = static_cast<LatestOpaqueEventType*>(opaquePort);
             return port->removeReceiver(handle);
         }, &BasicEvent::migratePort);
@@ -996,6 +1179,11 @@ namespace comm {
 
         BasicGlobalEvent(FArgs... args) noexcept : m_filter(std::in_place, std::move(args)...) {}
 
+        /// Returns false if nothing listens to this event, filtered or not
+        static bool hasListeners() noexcept {
+            return Event1Type::hasListeners() || Event2Type::hasListeners();
+        }
+
         template<class Callable>
         requires std::is_invocable_v<Callable, PArgs...>
         ListenerHandle listen(Callable listener, int priority = 0) const noexcept {
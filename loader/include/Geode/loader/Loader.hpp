@@ -16,6 +16,33 @@
 namespace geode {
     using ScheduledFunction = geode::Function<void()>;
 
+    /**
+     * How urgently a function queued with queueInMainThread needs to run.
+     * Each frame has a time budget for queued functions, anything that doesn't fit
+     * into it is carried over to the next frame, in order.
+     */
+    enum class MainThreadPriority : uint8_t {
+        /// Always runs on the next frame, regardless of the budget. Use for things the user is waiting on
+        Input = 0,
+        /// Runs on the next frame, unless the budget has already been used up
+        Normal = 1,
+        /// Only runs with whatever budget is left after everything else
+        Background = 2,
+    };
+
+    struct MainThreadQueueStats {
+        /// Amount of functions currently waiting to run
+        size_t pending = 0;
+        /// Amount of frames where the budget ran out and work was carried over
+        uint64_t stalledFrames = 0;
+        /// Total amount of times a function was carried over to a later frame
+        uint64_t deferrals = 0;
+        /// Time spent running queued functions on the last frame, in microseconds
+        uint64_t lastFrameMicros = 0;
+        /// Longest time spent running queued functions in a single frame, in microseconds
+        uint64_t longestFrameMicros = 0;
+    };
+
     struct LoadProblem {
         enum class Type : uint8_t {
             /// Some other fatal error (like binary loading failing)
@@ -125,6 +152,13 @@ namespace geode {
         }
 
         void queueInMainThread(ScheduledFunction&& func);
+        void queueInMainThread(ScheduledFunction&& func, MainThreadPriority priority);
+
+        /**
+         * Returns statistics about how much work the main thread queue has been doing,
+         * and how often it had to carry work over to later frames
+         */
+        MainThreadQueueStats getMainThreadQueueStats() const;
 
         /**
          * Returns the current game version.
@@ -157,6 +191,16 @@ namespace geode {
         Loader::get()->queueInMainThread(std::move(func));
     }
 
+    /**
+     * @brief Queues a function to run on the main thread with the given priority
+     *
+     * @param func the function to queue
+     * @param priority how urgently the function needs to run
+    */
+    inline void queueInMainThread(ScheduledFunction&& func, MainThreadPriority priority) {
+        Loader::get()->queueInMainThread(std::move(func), priority);
+    }
+
     /**
      * @brief Take the next mod to load
      *
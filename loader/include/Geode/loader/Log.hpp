@@ -59,6 +59,12 @@ namespace geode {
         /// Returns the path to the current log file
         GEODE_DLL std::filesystem::path const& getCurrentLogPath();
 
+        /// Returns every log file (plain or compressed) that covers part of the given time
+        /// range and contains at least one log of the given severity or higher
+        GEODE_DLL std::vector<std::filesystem::path> findLogFiles(
+            asp::SystemTime from, asp::SystemTime to, Severity minSeverity = Severity::Debug
+        );
+
         GEODE_DLL void pushNest(Mod* mod);
         GEODE_DLL void popNest(Mod* mod);
 
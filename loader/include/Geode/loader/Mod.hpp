@@ -373,6 +373,10 @@ namespace geode {
         /**
          * Claims an existing hook object, marking this mod as its owner.
          * If the hook has "auto enable" set, this will enable the hook.
+         * Hooks claimed while the mod's binary is loading (including from
+         * `$execute` blocks) are not enabled right away; they are all enabled
+         * together once the binary has loaded, and any errors doing so are
+         * logged instead of returned here.
          * @returns Returns a pointer to the hook, or an error if the
          * hook already has an owner, or was unable to enable the hook.
          */
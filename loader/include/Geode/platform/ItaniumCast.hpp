@@ -1,6 +1,7 @@
 #pragma once
 
 #include "_casts_shared.hpp"
+#include <cstddef>
 
 namespace geode::cast {
 
@@ -81,6 +82,24 @@ namespace geode::cast {
         return nullptr;
     }
 
+    // The result of a cast only depends on the object's vtable and the target type,
+    // so we remember the offset from the input pointer to the result (or that there
+    // was no match) and repeated casts become a single probe into a lookup table.
+    // The table is owned by the loader so every mod shares the same one.
+    struct TypeinfoCastCacheEntry {
+        VtableType const* m_vtable;
+        ClassTypeinfoType const* m_afterTypeinfo;
+        std::ptrdiff_t m_offset;
+        bool m_found;
+    };
+
+    GEODE_DLL TypeinfoCastCacheEntry const* findCachedTypeinfoCast(
+        VtableType const* vtable, ClassTypeinfoType const* afterTypeinfo
+    );
+    GEODE_DLL void cacheTypeinfoCast(
+        VtableType const* vtable, ClassTypeinfoType const* afterTypeinfo, std::ptrdiff_t offset, bool found
+    );
+
     inline void* typeinfoCastInternal(void* ptr, ClassTypeinfoType const* beforeTypeinfo, ClassTypeinfoType const* afterTypeinfo, size_t hint) {
         // we're not using either because uhhh idk
         // hint is for diamond inheritance iirc which is never
@@ -93,13 +112,25 @@ namespace geode::cast {
         (void)hint;
 
         auto vftable = *reinterpret_cast<VtableType const* const*>(ptr);
+
+        if (auto cached = findCachedTypeinfoCast(vftable, afterTypeinfo)) {
+            return cached->m_found ? static_cast<std::byte*>(ptr) + cached->m_offset : nullptr;
+        }
+
         auto dataPointer = static_cast<VtableTypeinfoType const*>(static_cast<CompleteVtableType const*>(vftable));
         auto typeinfo = dataPointer->m_typeinfo;
         auto basePtr = static_cast<std::byte*>(ptr) + dataPointer->m_offset;
 
         auto afterIdent = afterTypeinfo->m_typeinfoName;
 
-        return traverseTypeinfoFor(basePtr, typeinfo, afterIdent);
+        auto ret = traverseTypeinfoFor(basePtr, typeinfo, afterIdent);
+        if (ret) {
+            cacheTypeinfoCast(vftable, afterTypeinfo, static_cast<std::byte*>(ret) - static_cast<std::byte*>(ptr), true);
+        }
+        else {
+            cacheTypeinfoCast(vftable, afterTypeinfo, 0, false);
+        }
+        return ret;
     }
 
     template <class After, class Before>
@@ -26,12 +26,28 @@ namespace geode {
 
         static LazySprite* create(cocos2d::CCSize size, bool loadingCircle = true);
 
+        /**
+         * Load the image from a URL. Unless `ignoreCache` is set, the texture is cached under the URL,
+         * and the download is kept in Geode's HTTP cache (see `web::WebRequest::httpCache`)
+         */
         void loadFromUrl(std::string url, Format format = Format::kFmtUnKnown, bool ignoreCache = false);
         void loadFromFile(std::filesystem::path const& path, Format format = Format::kFmtUnKnown, bool ignoreCache = false);
         void loadFromData(std::vector<uint8_t> data, Format format = Format::kFmtUnKnown);
         void loadFromData(std::span<uint8_t const> data, Format format = Format::kFmtUnKnown);
         void loadFromData(uint8_t const* ptr, size_t size, Format format = Format::kFmtUnKnown);
 
+        /**
+         * Load the image from bytes fetched by a future, like a request that needs its own headers.
+         * The future is only created once the load starts, so this respects `setDeferUntilVisible`.
+         * @param cacheKey The key the texture is cached under, or empty to not cache it
+         * @param makeFuture Creates the future that fetches the image
+         */
+        void loadFromFuture(
+            std::string cacheKey,
+            geode::Function<arc::Future<Result<ByteVector>>()> makeFuture,
+            Format format = Format::kFmtUnKnown
+        );
+
         /**
          * Set the callback to be called once the sprite is fully loaded, or an error occurred.
          * @param callback The callback
@@ -44,6 +60,14 @@ namespace geode {
          */
         void setAutoResize(bool value);
 
+        /**
+         * Set whether loading from a URL, file or future should wait until the sprite is actually
+         * on screen, and not cut off by a scroll layer or clipping node it's in. Useful for long
+         * lists, where most items are never scrolled into view.
+         * By default is `false`.
+         */
+        void setDeferUntilVisible(bool value);
+
         /**
          * Returns whether the image is now loaded
          */
@@ -65,6 +89,8 @@ namespace geode {
         virtual bool initWithFile(const char* pszFilename, const cocos2d::CCRect& rect) override;
         using CCSprite::initWithFile;
 
+        virtual void visit() override;
+
     private:
         class Impl;
         std::unique_ptr<Impl> m_impl;
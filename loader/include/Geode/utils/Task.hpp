@@ -16,6 +16,10 @@ namespace geode {
 
         template <class T, class P>
         struct TaskAwaiter;
+
+        /// Runs the body of a Task on the blocking pool of the arc runtime,
+        /// or on a new thread if the runtime has already been shut down
+        GEODE_DLL void runTaskBody(geode::Function<void()> body);
     }
 
     template <typename T>
@@ -453,7 +457,15 @@ namespace geode {
          */
         static Task run(Run&& body, std::string name = "<Task>") {
             auto task = Task(Handle::create(name));
-            std::thread([handle = std::weak_ptr(task.m_handle), name = std::move(name), body = std::move(body)] mutable {
+            geode_internal::runTaskBody([handle = std::weak_ptr(task.m_handle), name = std::move(name), body = std::move(body)] mutable {
+                // don't bother starting if the task was cancelled while it was waiting for a thread
+                if (auto lock = handle.lock(); !lock || !lock->is(Status::Pending)) {
+                    Task::cancel(handle.lock());
+                    return;
+                }
+
+                // pool threads are shared, so give the name back afterwards
+                auto prevName = std::string(utils::thread::getName());
                 utils::thread::setName(fmt::format("Task '{}'", name));
                 auto result = body(
                     [handle](P progress) {
@@ -472,7 +484,8 @@ namespace geode {
                 else {
                     Task::finish(handle.lock(), std::move(*std::move(result).getValue()));
                 }
-            }).detach();
+                utils::thread::setName(std::move(prevName));
+            });
             return task;
         }
         /**
@@ -486,7 +499,14 @@ namespace geode {
          */
         static Task runWithCallback(RunWithCallback&& body, std::string name = "<Callback Task>") {
             auto task = Task(Handle::create(name));
-            std::thread([handle = std::weak_ptr(task.m_handle), name = std::move(name), body = std::move(body)] mutable {
+            geode_internal::runTaskBody([handle = std::weak_ptr(task.m_handle), name = std::move(name), body = std::move(body)] mutable {
+                // don't bother starting if the task was cancelled while it was waiting for a thread
+                if (auto lock = handle.lock(); !lock || lock->is(Status::Cancelled)) {
+                    Task::cancel(handle.lock());
+                    return;
+                }
+
+                auto prevName = std::string(utils::thread::getName());
                 utils::thread::setName(fmt::format("Task '{}'", name));
 
                 body(
@@ -508,7 +528,8 @@ namespace geode {
                         return !lock || lock->is(Status::Cancelled);
                     }
                 );
-            }).detach();
+                utils::thread::setName(std::move(prevName));
+            });
             return task;
         }
         /**
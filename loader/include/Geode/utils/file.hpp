@@ -194,6 +194,14 @@ namespace geode::utils::file {
 
         using Path = std::filesystem::path;
 
+        struct EntryInfo {
+            bool isDirectory;
+            // CRC32 of the uncompressed data, as stored in the central directory
+            uint32_t crc32;
+            int64_t compressedSize;
+            int64_t uncompressedSize;
+        };
+
         /**
          * Create unzipper for file
          */
@@ -203,6 +211,11 @@ namespace geode::utils::file {
          * Create unzipper for data in-memory
          */
         static Result<Unzip> create(ByteSpan data);
+        /**
+         * Create unzipper for data in-memory, taking ownership of the buffer
+         * instead of copying it
+         */
+        static Result<Unzip> create(ByteVector&& data);
 
         /**
          * Set a callback to be called with the progress of the unzip operation, first
@@ -230,6 +243,11 @@ namespace geode::utils::file {
          * @param name Entry path in zip
          */
         bool hasEntry(Path const& name);
+        /**
+         * Get information about an entry without extracting it
+         * @param name Entry path in zip
+         */
+        std::optional<EntryInfo> getEntryInfo(Path const& name) const;
 
         /**
          * Extract entry to memory
@@ -247,6 +265,14 @@ namespace geode::utils::file {
          * @param dir Directory to unzip the contents to
          */
         Result<> extractAllTo(Path const& dir);
+        /**
+         * Extract all entries to directory, skipping those the filter rejects.
+         * Skipped entries still count towards the progress callback
+         * @param dir Directory to unzip the contents to
+         * @param filter Called with the path of each entry in the zip, return
+         * false to leave it out
+         */
+        Result<> extractAllTo(Path const& dir, geode::Function<bool(Path const&)> filter);
 
         /**
          * Helper method for quickly unzipping a file
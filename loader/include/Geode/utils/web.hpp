@@ -228,6 +228,7 @@ namespace geode::utils::web {
         size_t m_uploadTotal = 0;
 
         friend class WebRequest;
+        friend class FileDownload;
 
     public:
         // Must be default-constructible for use in Promise
@@ -256,6 +257,7 @@ namespace geode::utils::web {
 
         friend class WebRequestsManager;
         friend struct WebFuture;
+        friend class FileDownload;
     public:
         WebRequest();
         ~WebRequest();
@@ -381,6 +383,20 @@ namespace geode::utils::web {
          */
         WebRequest& ignoreContentLength(bool enabled);
 
+        /**
+         * Keeps the response in Geode's on-disk HTTP cache, and answers the request from there
+         * for as long as the response's Cache-Control / Expires headers allow. After that, the
+         * cached response is revalidated with its ETag or Last-Modified header, so it only has
+         * to be downloaded again if it has changed.
+         * Only applies to GET requests without a body, range or data callback. Responses that
+         * vary by request headers (other than Accept-Encoding) are not kept.
+         * The default is false.
+         *
+         * @param enabled
+         * @return WebRequest&
+         */
+        WebRequest& httpCache(bool enabled);
+
         /**
          * Sets the Certificate Authority (CA) bundle content.
          * Defaults to sending the Geode CA bundle, found here: https://github.com/geode-sdk/net_libs/blob/main/ca_bundle.h
@@ -445,6 +461,15 @@ namespace geode::utils::web {
          */
         WebRequest& onProgress(Function<void(WebProgress const&)> callback);
 
+        /**
+         * Streams the body of successful (2xx) responses to this function as it
+         * arrives, instead of collecting it in the response. Error responses
+         * are still collected, so their message can be read as usual.
+         * Return false to abort the request.
+         * @note The callback is called on the networking thread
+         */
+        WebRequest& onData(Function<bool(ByteSpan)> callback);
+
         /**
          * Gets the unique request ID
          *
@@ -538,6 +563,55 @@ namespace geode::utils::web {
         std::shared_ptr<Impl> m_impl;
     };
 
+    /**
+     * Downloads a file straight to disk. If the server supports range requests, the file
+     * is split into segments which are downloaded in parallel, and progress is saved next
+     * to the file (in `<path>.state`), so an interrupted download picks up where it left
+     * off the next time the same URL is downloaded to the same path.
+     */
+    class GEODE_DLL FileDownload final {
+    private:
+        class Impl;
+
+        std::shared_ptr<Impl> m_impl;
+
+    public:
+        FileDownload();
+        ~FileDownload();
+
+        FileDownload& userAgent(std::string name);
+        FileDownload& header(std::string name, std::string value);
+        FileDownload& timeout(std::chrono::seconds time);
+
+        /**
+         * Sets how many segments may be downloaded at once. Small files always use fewer.
+         * The default is 4
+         */
+        FileDownload& segments(size_t count);
+
+        /**
+         * Sets the function that will be called on the main thread when progress is made,
+         * including progress that was resumed from a previous attempt
+         */
+        FileDownload& onProgress(Function<void(WebProgress const&)> callback);
+
+        /**
+         * Sets a function that sees every piece of data before it's written to the file,
+         * along with its offset in the file. Returning an error aborts the download.
+         * Pieces of different segments may arrive out of order and data resumed from a
+         * previous attempt is never passed here, but calls are never concurrent
+         * @note The callback is called on the networking thread
+         */
+        FileDownload& onData(Function<Result<>(uint64_t offset, ByteSpan data)> callback);
+
+        /**
+         * Downloads the file at the given URL to the given path. The state file is removed
+         * once the download is complete; on failure, both files are kept so the download
+         * can be resumed
+         */
+        arc::Future<Result<>> download(std::string url, std::filesystem::path path, Mod* mod = geode::getMod());
+    };
+
     /**
      * Allows you to intercept and modify requests before they're sent with either a mod ID filter or globally.
      *
@@ -193,7 +193,7 @@ void crashlog::updateFunctionBindings() {
     }
 
     async::spawn(
-        web::WebRequest().get(
+        web::WebRequest().httpCache(true).get(
             "https://prevter.github.io/bindings-meta/CodegenData-"
             GEODE_GD_VERSION_STRING "-"
             GEODE_WINDOWS("Win64") GEODE_INTEL_MAC("Intel") GEODE_ARM_MAC("Arm") GEODE_IOS("iOS")
@@ -191,17 +191,19 @@ int geodeEntry(void* platformData) {
 
     crashlog::setupPlatformHandlerPost();
 
-    // delete old log files
+    // delete and compress old log files
 
     int logMaxAge = Mod::get()->getSettingValue<int>("log-retention-period");
 
-    // 0 means no deletion
-    if (logMaxAge > 0) {
-        // put it in a task so that it doesn't slow down launch times
-        async::runtime().spawnBlocking<void>([logMaxAge] {
+    // put it in a task so that it doesn't slow down launch times
+    async::runtime().spawnBlocking<void>([logMaxAge] {
+        // 0 means no deletion
+        if (logMaxAge > 0) {
             log::Logger::get()->deleteOldLogs(std::chrono::days{logMaxAge});
-        });
-    }
+        }
+        // and compress whatever previous sessions left uncompressed
+        log::Logger::get()->compressOldLogs();
+    });
 
     log::debug("Setting up IPC");
     {
@@ -43,6 +43,10 @@ std::filesystem::path dirs::getIndexDir() {
     return dirs::getGeodeDir() / "index";
 }
 
+std::filesystem::path dirs::getCacheDir() {
+    return dirs::getGeodeDir() / "cache";
+}
+
 std::filesystem::path dirs::getCrashlogsDir() {
     return crashlog::getCrashLogDirectory();
 }
@@ -1,10 +1,48 @@
 #include <Geode/loader/Event.hpp>
+#include <Geode/loader/Log.hpp>
 #include <Geode/utils/ranges.hpp>
 #include <mutex>
+#include <unordered_set>
 
 using namespace geode::prelude;
 using namespace geode::comm;
 
+// EventInterest
+
+namespace {
+    class InterestRegistry {
+        std::mutex m_mutex;
+        // type names are used as the key since every module has its own type_info
+        std::unordered_map<std::string, std::unique_ptr<std::atomic_size_t>> m_counters;
+
+    public:
+        static InterestRegistry& get() {
+            static auto s_instance = new InterestRegistry();
+            return *s_instance;
+        }
+
+        std::atomic_size_t& counterFor(std::type_info const& type) {
+            auto lock = std::unique_lock<std::mutex>(m_mutex);
+            auto& counter = m_counters[type.name()];
+            if (!counter) {
+                counter = std::make_unique<std::atomic_size_t>(0);
+            }
+            return *counter;
+        }
+
+        void portAdded(BaseFilter const* filter) {
+            this->counterFor(typeid(*filter)).fetch_add(1, std::memory_order_relaxed);
+        }
+        void portRemoved(BaseFilter const* filter) {
+            this->counterFor(typeid(*filter)).fetch_sub(1, std::memory_order_relaxed);
+        }
+    };
+}
+
+std::atomic_size_t const& EventInterest::get(std::type_info const& type) noexcept {
+    return InterestRegistry::get().counterFor(type);
+}
+
 // EventCenterThreadLocal
 
 class EventCenterThreadLocal::Impl {
@@ -13,22 +51,142 @@ public:
     using ValueType = std::shared_ptr<OpaquePortBase>;
     using MapType = std::unordered_map<KeyType, ValueType, BaseFilterHash, BaseFilterEqual>;
 
+    struct Handover {
+        KeyType filter;
+        RemoveFuncType func;
+        MigrateFuncType migratePort;
+    };
+
+    // Only ever touched by the owning thread
     MapType m_ports;
+
+    // Removals handed over from other threads. The owning thread only checks
+    // the flag, so the common path doesn't synchronize with anyone.
+    std::mutex m_handoverMutex;
+    std::vector<Handover> m_handover;
+    std::atomic_bool m_hasHandover = false;
+
+    // Which center owns the filter that keys each port, used to find where to
+    // hand a removal over to. Only touched when ports are created or erased.
+    static inline std::mutex s_ownersMutex;
+    static inline std::unordered_map<BaseFilter const*, std::pair<Impl*, std::weak_ptr<BaseFilter>>> s_owners;
+
+    void registerOwner(KeyType const& filter) {
+        auto lock = std::unique_lock<std::mutex>(s_ownersMutex);
+        s_owners[filter.get()] = {this, filter};
+    }
+    void unregisterOwner(BaseFilter const* filter) {
+        auto lock = std::unique_lock<std::mutex>(s_ownersMutex);
+        s_owners.erase(filter);
+    }
+
+    // Ports are looked up by value, but a ListenerHandle always refers to the
+    // exact filter object that keys the port it was added to
+    MapType::iterator findOwned(BaseFilter const* filter) {
+        auto it = m_ports.find(filter);
+        if (it != m_ports.end() && it->first.get() == filter) {
+            return it;
+        }
+        return m_ports.end();
+    }
+
+    size_t removeFrom(MapType::iterator it, RemoveFuncType& func, MigrateFuncType& migratePort) {
+        if (auto newPort = std::invoke(migratePort, it->second.get())) {
+            it->second.reset(newPort);
+        }
+        auto size = std::invoke(func, it->second.get());
+        if (size == 0) {
+            // geode::console::log(fmt::format("Removing port for filter type {}", cast::getRuntimeTypeName(filter)), Severity::Debug);
+            this->unregisterOwner(it->first.get());
+            InterestRegistry::get().portRemoved(it->first.get());
+            m_ports.erase(it);
+        }
+        return size;
+    }
+
+    void applyHandover() {
+        if (!m_hasHandover.load(std::memory_order_relaxed)) return;
+
+        std::vector<Handover> handover;
+        {
+            auto lock = std::unique_lock<std::mutex>(m_handoverMutex);
+            handover.swap(m_handover);
+            m_hasHandover.store(false, std::memory_order_relaxed);
+        }
+        for (auto& entry : handover) {
+            auto it = this->findOwned(entry.filter.get());
+            if (it != m_ports.end()) {
+                this->removeFrom(it, entry.func, entry.migratePort);
+            }
+        }
+    }
+
+    // Returns false if no thread owns the filter anymore
+    static bool handOver(BaseFilter const* filter, RemoveFuncType& func, MigrateFuncType& migratePort) {
+        // the owners lock also keeps the owning center from going away
+        auto lock = std::unique_lock<std::mutex>(s_ownersMutex);
+        auto it = s_owners.find(filter);
+        if (it == s_owners.end()) return false;
+
+        auto owner = it->second.first;
+        auto key = it->second.second.lock();
+        if (!key) return false;
+
+        auto handoverLock = std::unique_lock<std::mutex>(owner->m_handoverMutex);
+        owner->m_handover.push_back({std::move(key), std::move(func), std::move(migratePort)});
+        owner->m_hasHandover.store(true, std::memory_order_relaxed);
+        return true;
+    }
+
+#ifndef NDEBUG
+    // A send that reaches nobody here while another thread listens for the exact
+    // same thing is almost always an event sent from the wrong thread
+    void warnIfOwnedElsewhere(BaseFilter const* filter) const {
+        if (EventInterest::get(typeid(*filter)).load(std::memory_order_relaxed) == 0) return;
+
+        static std::unordered_set<std::string> s_warned;
+        {
+            auto lock = std::unique_lock<std::mutex>(s_ownersMutex);
+            auto owned = std::ranges::any_of(s_owners, [&](auto const& pair) {
+                auto key = pair.second.second.lock();
+                return pair.second.first != this && key && *key == *filter;
+            });
+            if (!owned || !s_warned.insert(typeid(*filter).name()).second) return;
+        }
+        // logging may send events of its own, so not while holding the lock
+        log::warn(
+            "{} was sent on a thread without listeners for it, but another thread has some. "
+            "Thread local events only reach listeners on the thread they are sent from",
+            cast::getRuntimeTypeName(filter)
+        );
+    }
+#endif
 };
 
 EventCenterThreadLocal::EventCenterThreadLocal() : m_impl(std::make_unique<Impl>()) {}
 EventCenterThreadLocal::~EventCenterThreadLocal() = default;
 
 EventCenterThreadLocal* EventCenterThreadLocal::get() {
-    // TODO: make this back threadlocal
-    static auto s_instance = new EventCenterThreadLocal();
-    return s_instance;
+    // A center that still has ports when its thread exits is leaked on purpose,
+    // tearing down listeners during process shutdown isn't safe
+    struct Holder {
+        EventCenterThreadLocal* center = new EventCenterThreadLocal();
+        ~Holder() {
+            if (center->m_impl->m_ports.empty()) {
+                delete center;
+            }
+        }
+    };
+    static thread_local Holder s_holder;
+    return s_holder.center;
 }
 
 bool EventCenterThreadLocal::send(BaseFilter const* filter, SendFuncType func, MigrateFuncType migratePort) noexcept {
     // log::debug("EventCenterThreadLocal sending event for filter {}, {}", (void*)filter, cast::getRuntimeTypeName(filter));
     // log::debug("hash {} threadid {}", BaseFilterHash{}(filter), std::this_thread::get_id());
 
+    m_impl->applyHandover();
+
     auto it = m_impl->m_ports.find(filter);
     if (it != m_impl->m_ports.end()) {
         // log::debug("found port for filter {}", (void*)it->first.get());
@@ -39,22 +197,18 @@ bool EventCenterThreadLocal::send(BaseFilter const* filter, SendFuncType func, M
         auto port = it->second;
         return std::invoke(func, port.get());
     }
+#ifndef NDEBUG
+    m_impl->warnIfOwnedElsewhere(filter);
+#endif
     return false;
 }
 ListenerHandle EventCenterThreadLocal::addReceiver(BaseFilter const* filter, AddFuncType func, MigrateFuncType migratePort) noexcept {
     // log::debug("EventCenterThreadLocal adding receiver for filter {}, {}", (void*)filter, cast::getRuntimeTypeName(filter));
     // log::debug("hash {} threadid {}", BaseFilterHash{}(filter), std::this_thread::get_id());
 
-    auto it = m_impl->m_ports.find(filter);
-
-    // if (std::string(cast::getRuntimeTypeName(filter)).find("UpdateModListStateEvent") != std::string::npos) {
-    // if (it == m_impl->m_ports.end()) {
-    //     log::debug("in ports, not found");
-    // }
-    // else {
-    //     log::debug("in ports, found {} -> {}, ({})", (void*)it->first.get(), (void*)it->second.get(), cast::getRuntimeTypeName(it->first.get()));
-    // }}
+    m_impl->applyHandover();
 
+    auto it = m_impl->m_ports.find(filter);
     if (it != m_impl->m_ports.end()) {
         if (auto newPort = std::invoke(migratePort, it->second.get())) {
             it->second.reset(newPort);
@@ -63,37 +217,23 @@ ListenerHandle EventCenterThreadLocal::addReceiver(BaseFilter const* filter, Add
     }
     else {
         auto clonedFilter = Impl::KeyType(filter->clone());
-        // if (std::string(cast::getRuntimeTypeName(filter)).find("UpdateModListStateEvent") != std::string::npos) {
-        // log::debug("cloned filter {}, typename {}", (void*)clonedFilter.get(), cast::getRuntimeTypeName(clonedFilter.get()));
-        // }
         if (!clonedFilter) return ListenerHandle();
-        auto filter2 = clonedFilter.get();
-        // geode::console::log(fmt::format("Cloned filter for adding receiver {}, {}", (void*)filter2, cast::getRuntimeTypeName(filter2)), Severity::Debug);
 
         auto port = Impl::ValueType(clonedFilter->getPort());
         if (!port) return ListenerHandle();
 
         ReceiverHandle handle = std::invoke(func, port.get());
-        // if (std::string(cast::getRuntimeTypeName(filter)).find("UpdateModListStateEvent") != std::string::npos) {
-        // log::debug("handle {}", handle);
-        // }
         auto ret = ListenerHandle(clonedFilter, handle, nullptr);
 
+        m_impl->registerOwner(clonedFilter);
+        InterestRegistry::get().portAdded(clonedFilter.get());
         m_impl->m_ports.emplace(std::move(clonedFilter), std::move(port));
-
-        auto it2 = m_impl->m_ports.find(filter);
-    //     if (std::string(cast::getRuntimeTypeName(filter)).find("UpdateModListStateEvent") != std::string::npos) {
-    //     if (it2 == m_impl->m_ports.end()) {
-    //         log::debug("added into ports, not found");
-    //     }
-    //     else {
-    //         log::debug("added into ports, found {} -> {}", (void*)it2->first.get(), (void*)it2->second.get());
-    //     }
-    // }
         return ret;
     }
 }
 size_t EventCenterThreadLocal::getReceiverCount(BaseFilter const* filter, SizeFuncType func, MigrateFuncType migratePort) noexcept {
+    m_impl->applyHandover();
+
     auto it = m_impl->m_ports.find(filter);
     if (it != m_impl->m_ports.end()) {
         if (auto newPort = std::invoke(migratePort, it->second.get())) {
@@ -107,35 +247,96 @@ size_t EventCenterThreadLocal::removeReceiver(BaseFilter const* filter, RemoveFu
     // log::debug("EventCenterThreadLocal removing receiver for filter {}, {}", (void*)filter, cast::getRuntimeTypeName(filter));
     // log::debug("hash {} threadid {}", BaseFilterHash{}(filter), std::this_thread::get_id());
 
+    m_impl->applyHandover();
+
+    // Code built against older headers may capture by reference in func, so it
+    // can't be handed over to another thread. Before centers were per-thread it
+    // would only ever have found the port in this one anyway.
     auto it = m_impl->m_ports.find(filter);
     if (it != m_impl->m_ports.end()) {
-        if (auto newPort = std::invoke(migratePort, it->second.get())) {
-            it->second.reset(newPort);
-        }
-        auto size = std::invoke(func, it->second.get());
-        if (size == 0) {
-            // geode::console::log(fmt::format("Removing port for filter type {}", cast::getRuntimeTypeName(filter)), Severity::Debug);
-            m_impl->m_ports.erase(it);
-        }
+        return m_impl->removeFrom(it, func, migratePort);
+    }
+    return (size_t)-1;
+}
+size_t EventCenterThreadLocal::removeReceiverV2(BaseFilter const* filter, RemoveFuncType func, MigrateFuncType migratePort) noexcept {
+    m_impl->applyHandover();
 
-        // if (std::string(cast::getRuntimeTypeName(filter)).find("UpdateModListStateEvent") != std::string::npos) {
-        //     log::debug("port size {}", size);
-        // }
-        return size;
+    auto it = m_impl->findOwned(filter);
+    if (it != m_impl->m_ports.end()) {
+        return m_impl->removeFrom(it, func, migratePort);
     }
+
+    // the listener was registered on another thread
+    Impl::handOver(filter, func, migratePort);
     return (size_t)-1;
 }
 
 // EventCenterGlobal
 
+// The port map is published as an immutable snapshot, so sends never lock,
+// and receivers always run outside the lock. Anything that changes the map
+// (adding or erasing a port, or swapping in a migrated one) holds m_writeMutex
+// and publishes a new copy. Migrating can only happen for ports created by
+// older code, and only that runs under m_writeMutex.
 class EventCenterGlobal::Impl {
 public:
     using KeyType = std::shared_ptr<BaseFilter>;
     using ValueType = std::shared_ptr<OpaquePortBase>;
     using MapType = std::unordered_map<KeyType, ValueType, BaseFilterHash, BaseFilterEqual>;
 
-    std::mutex m_mutex;
-    MapType m_ports;
+    std::mutex m_writeMutex;
+    asp::PtrSwap<MapType> m_ports;
+
+    Impl() : m_ports(asp::make_shared<MapType>()) {}
+
+    // Must be called with m_writeMutex held. If another thread already migrated
+    // the port in the meantime, theirs is kept and ours is thrown away.
+    ValueType adoptMigratedPort(BaseFilter const* filter, ValueType const& oldPort, OpaquePortBase* migrated) {
+        auto ports = m_ports.load();
+        auto it = ports->find(filter);
+        if (it == ports->end() || it->second != oldPort) {
+            delete migrated;
+            return it == ports->end() ? oldPort : it->second;
+        }
+
+        auto newPort = ValueType(migrated);
+        auto newPorts = asp::make_shared<MapType>(*ports.get());
+        newPorts->find(filter)->second = newPort;
+        m_ports.store(std::move(newPorts));
+        return newPort;
+    }
+
+    // Used by senders. The old port may still be in use on other threads and
+    // migrating moves its pending adds and removes out, so migratePort always
+    // runs under the lock on whatever port the map holds by then. Ports that
+    // are already the latest version are returned straight from the snapshot.
+    ValueType findPort(BaseFilter const* filter, MigrateFuncType& migratePort) {
+        auto ports = m_ports.load();
+        auto it = ports->find(filter);
+        if (it == ports->end()) {
+            return nullptr;
+        }
+        if (typeinfo_cast<OpaquePortV4Tag*>(it->second.get())) {
+            return it->second;
+        }
+
+        auto lock = std::unique_lock<std::mutex>(m_writeMutex);
+        return this->findPortLocked(filter, migratePort).second;
+    }
+
+    // Must be called with m_writeMutex held
+    std::pair<KeyType, ValueType> findPortLocked(BaseFilter const* filter, MigrateFuncType& migratePort) {
+        auto ports = m_ports.load();
+        auto it = ports->find(filter);
+        if (it == ports->end()) {
+            return {};
+        }
+
+        if (auto newPort = std::invoke(migratePort, it->second.get())) {
+            return {it->first, this->adoptMigratedPort(filter, it->second, newPort)};
+        }
+        return *it;
+    }
 };
 
 EventCenterGlobal::EventCenterGlobal() : m_impl(std::make_unique<Impl>()) {}
@@ -149,17 +350,7 @@ EventCenterGlobal* EventCenterGlobal::get() {
 bool EventCenterGlobal::send(BaseFilter const* filter, SendFuncType func, MigrateFuncType migratePort) noexcept {
     // log::debug("EventCenterGlobal sending event for filter {}, {}", (void*)filter, cast::getRuntimeTypeName(filter));
 
-    auto lock = std::unique_lock<std::mutex>(m_impl->m_mutex);
-    auto it = m_impl->m_ports.find(filter);
-    auto const end = m_impl->m_ports.end();
-
-    if (it != end) {
-        if (auto newPort = std::invoke(migratePort, it->second.get())) {
-            it->second.reset(newPort);
-        }
-
-        auto port = it->second;
-        lock.unlock();
+    if (auto port = m_impl->findPort(filter, migratePort)) {
         return std::invoke(func, port.get());
     }
     return false;
@@ -167,44 +358,32 @@ bool EventCenterGlobal::send(BaseFilter const* filter, SendFuncType func, Migrat
 ListenerHandle EventCenterGlobal::addReceiver(BaseFilter const* filter, AddFuncType func, MigrateFuncType migratePort) noexcept {
     // log::debug("EventCenterGlobal adding receiver for filter {}, {}", (void*)filter, cast::getRuntimeTypeName(filter));
 
-    auto lock = std::unique_lock<std::mutex>(m_impl->m_mutex);
-    auto it = m_impl->m_ports.find(filter);
-    auto const end = m_impl->m_ports.end();
+    // held for the whole call so a concurrent removeReceiver can't erase the port
+    // between us finding it and adding to it
+    auto lock = std::unique_lock<std::mutex>(m_impl->m_writeMutex);
 
-    if (it != end) {
-        if (auto newPort = std::invoke(migratePort, it->second.get())) {
-            it->second.reset(newPort);
-        }
-        return ListenerHandle(it->first, std::invoke(func, it->second.get()), nullptr);
+    auto [key, port] = m_impl->findPortLocked(filter, migratePort);
+    if (port) {
+        return ListenerHandle(key, std::invoke(func, port.get()), nullptr);
     }
-    else {
-        auto clonedFilter = Impl::KeyType(filter->clone());
-        if (!clonedFilter) return ListenerHandle();
-        auto filter2 = clonedFilter.get();
-        // geode::console::log(fmt::format("Cloned filter for adding receiver {}, {}", (void*)filter2, cast::getRuntimeTypeName(filter2)), Severity::Debug);
 
-        auto port = Impl::ValueType(clonedFilter->getPort());
-        if (!port) return ListenerHandle();
+    auto clonedFilter = Impl::KeyType(filter->clone());
+    if (!clonedFilter) return ListenerHandle();
 
-        ReceiverHandle handle = std::invoke(func, port.get());
-        auto ret = ListenerHandle(clonedFilter, handle, nullptr);
+    auto newPort = Impl::ValueType(clonedFilter->getPort());
+    if (!newPort) return ListenerHandle();
 
-        m_impl->m_ports.emplace(std::move(clonedFilter), std::move(port));
-        return ret;
-    }
+    ReceiverHandle handle = std::invoke(func, newPort.get());
+    auto ret = ListenerHandle(clonedFilter, handle, nullptr);
+
+    InterestRegistry::get().portAdded(clonedFilter.get());
+    auto newPorts = asp::make_shared<Impl::MapType>(*m_impl->m_ports.load().get());
+    newPorts->emplace(std::move(clonedFilter), std::move(newPort));
+    m_impl->m_ports.store(std::move(newPorts));
+    return ret;
 }
 size_t EventCenterGlobal::getReceiverCount(BaseFilter const* filter, SizeFuncType func, MigrateFuncType migratePort) noexcept {
-    auto lock = std::unique_lock<std::mutex>(m_impl->m_mutex);
-    auto it = m_impl->m_ports.find(filter);
-    auto const end = m_impl->m_ports.end();
-
-    if (it != end) {
-        if (auto newPort = std::invoke(migratePort, it->second.get())) {
-            it->second.reset(newPort);
-        }
-
-        auto port = it->second;
-        lock.unlock();
+    if (auto port = m_impl->findPort(filter, migratePort)) {
         return std::invoke(func, port.get());
     }
     return 0;
@@ -212,20 +391,23 @@ size_t EventCenterGlobal::getReceiverCount(BaseFilter const* filter, SizeFuncTyp
 size_t EventCenterGlobal::removeReceiver(BaseFilter const* filter, RemoveFuncType func, MigrateFuncType migratePort) noexcept {
     // log::debug("EventCenterGlobal removing receiver for filter {}, {}", (void*)filter, cast::getRuntimeTypeName(filter));
 
-    auto lock = std::unique_lock<std::mutex>(m_impl->m_mutex);
-    auto it = m_impl->m_ports.find(filter);
-    auto const end = m_impl->m_ports.end();
+    auto lock = std::unique_lock<std::mutex>(m_impl->m_writeMutex);
 
-    if (it != end) {
-        if (auto newPort = std::invoke(migratePort, it->second.get())) {
-            it->second.reset(newPort);
-        }
-        auto size = std::invoke(func, it->second.get());
+    auto [key, port] = m_impl->findPortLocked(filter, migratePort);
+    if (port) {
+        auto size = std::invoke(func, port.get());
         if (size == 0) {
             // geode::console::log(fmt::format("Removing port for filter type {}", cast::getRuntimeTypeName(filter)), Severity::Debug);
-            m_impl->m_ports.erase(it);
+            // senders still holding the old snapshot keep the port alive until they're done
+            InterestRegistry::get().portRemoved(key.get());
+            auto newPorts = asp::make_shared<Impl::MapType>(*m_impl->m_ports.load().get());
+            newPorts->erase(key);
+            m_impl->m_ports.store(std::move(newPorts));
         }
         return size;
     }
     return (size_t)-1;
+}
+size_t EventCenterGlobal::removeReceiverV2(BaseFilter const* filter, RemoveFuncType func, MigrateFuncType migratePort) noexcept {
+    return this->removeReceiver(filter, std::move(func), std::move(migratePort));
 }
\ No newline at end of file
@@ -45,10 +45,26 @@ std::shared_ptr<Hook> Hook::Impl::create(
 }
 
 Result<> Hook::Impl::enable() {
-    if (m_enabled) {
+    GEODE_UNWRAP_INTO(auto enabled, this->enableQuietly());
+    if (!enabled) {
         return Ok();
     }
 
+    if (m_owner) {
+        log::debug("Enabled {} hook at {} for {}", m_displayName, m_address, m_owner->getID());
+    }
+    else {
+        log::debug("Enabled {} hook at {}", m_displayName, m_address);
+    }
+
+    return Ok();
+}
+
+Result<bool> Hook::Impl::enableQuietly() {
+    if (m_enabled) {
+        return Ok(false);
+    }
+
     // During a transition between updates when it's important to get a
     // non-functional version that compiles, address 0x9999999 is used to mark
     // functions not yet RE'd but that would prevent compilation
@@ -62,21 +78,14 @@ Result<> Hook::Impl::enable() {
         else {
             log::warn("Hook {} uses placeholder address, refusing to hook", m_displayName);
         }
-        return Ok();
+        return Ok(false);
     }
 
     GEODE_UNWRAP_INTO(auto handler, LoaderImpl::get()->getOrCreateHandler(m_address, m_handlerMetadata));
     m_handle = tulip::hook::createHook(handler, m_detour, m_hookMetadata);
     m_enabled = true;
 
-    if (m_owner) {
-        log::debug("Enabled {} hook at {} for {}", m_displayName, m_address, m_owner->getID());
-    }
-    else {
-        log::debug("Enabled {} hook at {}", m_displayName, m_address);
-    }
-
-    return Ok();
+    return Ok(true);
 }
 
 Result<> Hook::Impl::disable() {
@@ -48,6 +48,9 @@ public:
     tulip::hook::HookHandle m_handle = 0;
 
     Result<> enable();
+    // same as enable but without logging, for enabling many hooks at once;
+    // returns whether the hook was actually enabled
+    Result<bool> enableQuietly();
     Result<> disable();
     Result<> toggle();
     Result<> toggle(bool enable);
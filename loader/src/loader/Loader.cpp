@@ -79,6 +79,14 @@ void Loader::queueInMainThread(ScheduledFunction&& func) {
     return m_impl->queueInMainThread(std::forward<ScheduledFunction>(func));
 }
 
+void Loader::queueInMainThread(ScheduledFunction&& func, MainThreadPriority priority) {
+    return m_impl->queueInMainThread(std::forward<ScheduledFunction>(func), priority);
+}
+
+MainThreadQueueStats Loader::getMainThreadQueueStats() const {
+    return m_impl->getMainThreadQueueStats();
+}
+
 std::string Loader::getGameVersion() {
     return m_impl->getGameVersion();
 }
@@ -3,7 +3,9 @@
 
 #include "ModImpl.hpp"
 #include "ModMetadataImpl.hpp"
+#include "ModMetadataCache.hpp"
 #include "LogImpl.hpp"
+#include "Tracing.hpp"
 #include "console.hpp"
 
 #include <Geode/loader/Event.hpp>
@@ -19,6 +21,8 @@
 #include <Geode/utils/string.hpp>
 #include <Geode/utils/web.hpp>
 #include <about.hpp>
+#include <atomic>
+#include <chrono>
 #include <crashlog.hpp>
 #include <fmt/format.h>
 #include <hash.hpp>
@@ -36,6 +40,16 @@
 
 using namespace geode::prelude;
 
+// packages are read on at most this many threads during mod discovery
+static constexpr size_t MAX_DISCOVERY_THREADS = 8;
+
+// how many late mods may be unzipped at once, and how far ahead in the load order to look
+static constexpr size_t MAX_LATE_UNZIPS = 4;
+static constexpr size_t LATE_UNZIP_LOOKAHEAD = 8;
+
+// how long queued main thread functions may take per frame before being carried over
+static constexpr auto MAIN_THREAD_QUEUE_BUDGET = std::chrono::milliseconds(4);
+
 comm::EventCenter* geode::comm::EventCenter::get() {
     static auto s_instance = new EventCenter();
     return s_instance;
@@ -88,6 +102,11 @@ Result<> Loader::Impl::setup() {
         this->initLaunchArguments();
     }
 
+    if (this->getLaunchFlag("trace-startup")) {
+        log::info("Startup tracing enabled");
+        trace::enable();
+    }
+
     if (auto value = this->getLaunchArgument("use-common-handler-offset")) {
         log::info("Using common handler offset: {}", value.value());
         log::NestScope nest;
@@ -317,41 +336,124 @@ void Loader::Impl::addProblem(LoadProblem const& problem) {
 // Dependencies and refreshing
 
 void Loader::Impl::queueMods(std::vector<ModMetadata>& modQueue) {
+    struct Candidate {
+        std::filesystem::path path;
+        std::string key;
+        uint64_t size = 0;
+        int64_t modifiedTime = 0;
+        std::optional<ModMetadata> metadata;
+        // set if the package had to be read this launch
+        std::optional<ModMetadataCache::Entry> fresh;
+    };
+    std::vector<Candidate> candidates;
+
     for (auto const& dir : m_modSearchDirectories) {
         log::debug("Searching {}", dir);
-        log::NestScope nest;
         for (auto const& entry : std::filesystem::directory_iterator(dir)) {
             if (!std::filesystem::is_regular_file(entry) ||
                 entry.path().extension() != GEODE_MOD_EXTENSION)
                 continue;
 
-            log::debug("Found {}", entry.path().filename());
-            log::NestScope nest;
-
-            auto modMetadata = ModMetadata::createFromGeodeFile(entry.path());
+            std::error_code ec;
+            auto& candidate = candidates.emplace_back();
+            candidate.path = entry.path();
+            candidate.key = utils::string::pathToString(entry.path());
+            candidate.size = entry.file_size(ec);
+            candidate.modifiedTime = entry.last_write_time(ec).time_since_epoch().count();
+        }
+    }
 
-            log::debug("id: {}", modMetadata.getID());
-            log::debug("version: {}", modMetadata.getVersion());
-            log::debug("early: {}", modMetadata.needsEarlyLoad() ? "yes" : "no");
+    // unchanged packages don't need to be opened at all, everything else is read in parallel
+    auto cachePath = dirs::getModRuntimeDir() / "metadata-cache.bin";
+    auto cache = ModMetadataCache::load(cachePath);
 
-            if (std::find_if(modQueue.begin(), modQueue.end(), [&](auto& item) {
-                    return modMetadata.getID() == item.getID();
-                }) != modQueue.end()) {
-                log::error("Failed to queue: a mod with the same ID is already queued");
+    std::atomic_size_t next = 0;
+    auto work = [&] {
+        for (size_t i; (i = next.fetch_add(1, std::memory_order::relaxed)) < candidates.size();) {
+            auto& candidate = candidates[i];
+            if (auto cached = cache.find(candidate.key, candidate.size, candidate.modifiedTime)) {
+                candidate.metadata = ModMetadataImpl::createFromPackage(candidate.path, cached->contents);
+                continue;
+            }
 
-                auto modMetadata = ModMetadataImpl::createInvalidMetadata(
-                    entry.path(),
-                    "A mod with the same ID is already present.",
-                    // Passing `nullopt` to `createInvalidMetadata` generates a
-                    // random non-conflicting ID
-                    std::nullopt
+            auto contents = ModMetadataImpl::readPackage(candidate.path);
+            if (!contents) {
+                candidate.metadata = ModMetadataImpl::createInvalidMetadata(
+                    candidate.path, contents.unwrapErr(), ModMetadataImpl::guessIDFromPath(candidate.path)
                 );
-                modQueue.push_back(modMetadata);
-
                 continue;
             }
+            candidate.metadata = ModMetadataImpl::createFromPackage(candidate.path, contents.unwrap());
+            if (!contents.unwrap().specialFilesError) {
+                candidate.fresh = ModMetadataCache::Entry {
+                    .size = candidate.size,
+                    .modifiedTime = candidate.modifiedTime,
+                    .contents = std::move(contents).unwrap(),
+                };
+            }
+        }
+    };
+
+    auto threadCount = std::min<size_t>({
+        std::max(std::thread::hardware_concurrency(), 1u), MAX_DISCOVERY_THREADS, candidates.size()
+    });
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threadCount; i++) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // rebuild the cache from what's installed now, so removed mods drop out of it
+    bool cacheChanged = false;
+    ModMetadataCache newCache;
+
+    std::unordered_set<std::string> queuedIDs;
+    for (auto const& metadata : modQueue) {
+        queuedIDs.insert(metadata.getID());
+    }
+
+    for (auto& candidate : candidates) {
+        log::debug("Found {}", candidate.path.filename());
+        log::NestScope nest;
+
+        auto& modMetadata = *candidate.metadata;
 
+        log::debug("id: {}", modMetadata.getID());
+        log::debug("version: {}", modMetadata.getVersion());
+        log::debug("early: {}", modMetadata.needsEarlyLoad() ? "yes" : "no");
+
+        if (candidate.fresh) {
+            newCache.insert(candidate.key, std::move(*candidate.fresh));
+            cacheChanged = true;
+        }
+        else if (auto cached = cache.find(candidate.key, candidate.size, candidate.modifiedTime)) {
+            newCache.insert(candidate.key, *cached);
+        }
+
+        if (!queuedIDs.insert(modMetadata.getID()).second) {
+            log::error("Failed to queue: a mod with the same ID is already queued");
+
+            auto modMetadata = ModMetadataImpl::createInvalidMetadata(
+                candidate.path,
+                "A mod with the same ID is already present.",
+                // Passing `nullopt` to `createInvalidMetadata` generates a
+                // random non-conflicting ID
+                std::nullopt
+            );
             modQueue.push_back(modMetadata);
+
+            continue;
+        }
+
+        modQueue.push_back(modMetadata);
+    }
+
+    if (cacheChanged || newCache.size() != cache.size()) {
+        if (auto res = newCache.save(cachePath); !res) {
+            log::warn("Failed to save mod metadata cache: {}", res.unwrapErr());
         }
     }
 }
@@ -486,6 +588,8 @@ void Loader::Impl::buildModGraph() {
 }
 
 void Loader::Impl::loadModGraph(Mod* node, bool early) {
+    trace::Span span("loadModGraph", node);
+
     // Check version first, as it's not worth trying to load a mod with an
     // invalid target version
     // Also this makes it so that when GD updates, outdated mods get shown as
@@ -511,65 +615,101 @@ void Loader::Impl::loadModGraph(Mod* node, bool early) {
     }
 
     m_currentlyLoadingMod = node;
-    m_refreshingModCount += 1;
     m_refreshedModCount += 1;
     m_lateRefreshedModCount += early ? 0 : 1;
 
-    auto unzipFunction = [this, node]() {
-        log::debug("Unzipping .geode file");
-        auto res = this->unzipGeodeFile(node->getMetadata());
-        return res;
-    };
-
-    auto loadFunction = [this, node, early]() {
-        if (node->shouldLoad()) {
-            log::debug("Loading binary");
-            auto res = node->m_impl->loadBinary();
-            if (!res) {
-                this->addProblem({
-                    LoadProblem::Type::Unknown,
-                    node,
-                    res.unwrapErr()
-                });
-                log::error("Failed to load binary: {}", res.unwrapErr());
-                m_refreshingModCount -= 1;
-                return;
-            }
+    auto res = [&]() -> Result<> {
+        if (early) {
+            log::debug("Unzipping .geode file");
+            trace::Span span("unzipGeodeFile", node);
+            return this->unzipGeodeFile(node->getMetadata());
         }
+        // late mods have already been unzipped by startLateUnzip
+        auto it = m_lateUnzips.find(node);
+        if (it == m_lateUnzips.end() || !it->second) {
+            return Err("Mod was not unzipped before loading");
+        }
+        return std::move(*it->second);
+    }();
+    if (!res) {
+        this->addProblem({ LoadProblem::Type::Unknown, node, res.unwrapErr() });
+        log::error("Failed to unzip: {}", res.unwrapErr());
+        return;
+    }
 
-        m_refreshingModCount -= 1;
-    };
-
-    if (early) {
-        auto res = unzipFunction();
+    if (node->shouldLoad()) {
+        log::debug("Loading binary");
+        auto res = node->m_impl->loadBinary();
         if (!res) {
-            this->addProblem({ LoadProblem::Type::Unknown, node, res.unwrapErr() });
-            log::error("Failed to unzip: {}", res.unwrapErr());
-            m_refreshingModCount -= 1;
+            this->addProblem({
+                LoadProblem::Type::Unknown,
+                node,
+                res.unwrapErr()
+            });
+            log::error("Failed to load binary: {}", res.unwrapErr());
             return;
         }
-        loadFunction();
     }
-    else {
-        auto nest = log::saveNest();
-
-        async::runtime().spawnBlocking<void>([=, this]() {
-            log::loadNest(nest);
-            auto res = unzipFunction();
-            this->queueInMainThread([=, this, res = std::move(res)]() {
-                auto prevNest = log::saveNest();
-                log::loadNest(nest);
-                if (!res) {
-                    this->addProblem({ LoadProblem::Type::Unknown, node, res.unwrapErr() });
-                    log::error("Failed to unzip: {}", res.unwrapErr());
-                    m_refreshingModCount -= 1;
-                    log::loadNest(prevNest);
-                    return;
-                }
-                loadFunction();
-                log::loadNest(prevNest);
-            });
+}
+
+void Loader::Impl::startLateUnzip(Mod* node) {
+    m_lateUnzips[node] = std::nullopt;
+    m_lateUnzipsInFlight += 1;
+
+    auto nest = log::saveNest();
+    async::runtime().spawnBlocking<void>([=, this]() {
+        log::loadNest(nest);
+        auto res = [&] {
+            trace::Span span("unzipGeodeFile", node);
+            return this->unzipGeodeFile(node->getMetadata());
+        }();
+        this->queueInMainThread([=, this, res = std::move(res)]() mutable {
+            m_lateUnzips[node] = std::move(res);
+            m_lateUnzipsInFlight -= 1;
         });
+    });
+}
+
+bool Loader::Impl::shouldUnzipLate(Mod* node, bool lookahead) {
+    // same checks loadModGraph does before unzipping
+    if (node->isLoaded()) {
+        return false;
+    }
+    if (!node->getMetadata().checkGameVersion() || !node->getMetadata().checkGeodeVersion()) {
+        return false;
+    }
+    if (node->hasUnresolvedIncompatibilities()) {
+        return false;
+    }
+    if (!lookahead) {
+        return !node->hasUnresolvedDependencies();
+    }
+
+    // mods further down the queue may still be waiting for their dependencies
+    // to load, so only skip them if a dependency can never be resolved
+    for (auto const& dep : node->getMetadata().getDependencies()) {
+        if (dep.isResolved()) {
+            continue;
+        }
+        auto depMod = dep.getMod();
+        if (!depMod || !dep.getVersion().compare(depMod->getVersion()) || !depMod->shouldLoad()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Loader::Impl::startLateUnzips() {
+    // only look a few mods ahead, so the next mod to load is always among the first to be unzipped
+    size_t lookedAt = 0;
+    for (auto mod : m_modsToLoad) {
+        if (m_lateUnzipsInFlight >= MAX_LATE_UNZIPS || lookedAt++ >= LATE_UNZIP_LOOKAHEAD) {
+            break;
+        }
+        if (m_lateUnzips.contains(mod) || !this->shouldUnzipLate(mod, true)) {
+            continue;
+        }
+        this->startLateUnzip(mod);
     }
 }
 
@@ -760,6 +900,7 @@ void Loader::Impl::refreshModGraph() {
     std::vector<ModMetadata> modQueue;
     {
         log::NestScope nest;
+        trace::Span span("queueMods");
         this->queueMods(modQueue);
     }
 
@@ -767,6 +908,7 @@ void Loader::Impl::refreshModGraph() {
     log::info("Populating mod list");
     {
         log::NestScope nest;
+        trace::Span span("populateModList");
         this->populateModList(modQueue);
         modQueue.clear();
     }
@@ -775,12 +917,14 @@ void Loader::Impl::refreshModGraph() {
     log::info("Building mod graph");
     {
         log::NestScope nest;
+        trace::Span span("buildModGraph");
         this->buildModGraph();
     }
 
     log::info("Ordering mod stack");
     {
         log::NestScope nest;
+        trace::Span span("orderModStack");
         this->orderModStack();
     }
 
@@ -801,6 +945,7 @@ void Loader::Impl::refreshModGraph() {
     log::debug("Took {}s. Continuing next frame...", static_cast<float>(time) / 1000.f);
 
     m_loadingState = LoadingState::Mods;
+    m_timerBegin = std::chrono::high_resolution_clock::now();
 
     queueInMainThread([this]() {
         utils::thread::setName("Main");
@@ -854,40 +999,77 @@ void Loader::Impl::orderModStack() {
 }
 
 void Loader::Impl::continueRefreshModGraph() {
-    if (m_refreshingModCount != 0) {
-        queueInMainThread([this]() {
-            this->continueRefreshModGraph();
-        });
-        return;
-    }
-
-    if  (m_lateRefreshedModCount > 0) {
-        auto end = std::chrono::high_resolution_clock::now();
-        auto time = std::chrono::duration_cast<std::chrono::milliseconds>(end - m_timerBegin).count();
-        log::debug("Took {}s", static_cast<float>(time) / 1000.f);
-    }
-
     log::debug("Continuing mod graph refresh...");
     log::NestScope nest;
 
-    m_timerBegin = std::chrono::high_resolution_clock::now();
+    auto frameBegin = std::chrono::high_resolution_clock::now();
+    trace::Span span("continueRefreshModGraph");
 
     switch (m_loadingState) {
-        case LoadingState::Mods:
-            if (!m_modsToLoad.empty()) {
+        case LoadingState::Mods: {
+            // load as many mods as fit in the budget, keeping the order from orderModStack
+            auto budget = std::chrono::milliseconds(Mod::get()->getSettingValue<int64_t>("mod-load-budget"));
+            this->startLateUnzips();
+            while (!m_modsToLoad.empty()) {
                 auto mod = m_modsToLoad.front();
+                if (this->shouldUnzipLate(mod, false)) {
+                    auto it = m_lateUnzips.find(mod);
+                    if (it == m_lateUnzips.end()) {
+                        this->startLateUnzip(mod);
+                        break;
+                    }
+                    if (!it->second) {
+                        break;
+                    }
+                }
+
                 m_modsToLoad.pop_front();
                 log::info("Loading mod {} {}", mod->getID(), mod->getVersion());
+                auto begin = std::chrono::high_resolution_clock::now();
                 this->loadModGraph(mod, false);
+                auto end = std::chrono::high_resolution_clock::now();
+                m_lateUnzips.erase(mod);
+
+                auto time = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
+                m_modLoadTimes.push_back({ mod, time });
+                log::debug("Took {}ms", static_cast<float>(time.count()) / 1000.f);
+
+                this->startLateUnzips();
+                trace::counter("pendingMods", m_modsToLoad.size());
+                if (end - frameBegin >= budget) {
+                    break;
+                }
+            }
+            if (!m_modsToLoad.empty()) {
                 break;
             }
+
             m_loadingState = LoadingState::Problems;
+            if (m_lateRefreshedModCount > 0) {
+                auto end = std::chrono::high_resolution_clock::now();
+                auto total = std::chrono::duration_cast<std::chrono::milliseconds>(end - m_timerBegin).count();
+                log::debug("Loading non-early mods took {}s", static_cast<float>(total) / 1000.f);
+
+                std::sort(m_modLoadTimes.begin(), m_modLoadTimes.end(), [](auto const& a, auto const& b) {
+                    return a.second > b.second;
+                });
+                log::debug("Slowest mods to load:");
+                log::NestScope slowestNest;
+                for (size_t i = 0; i < m_modLoadTimes.size() && i < 5; i++) {
+                    auto& [mod, took] = m_modLoadTimes[i];
+                    log::debug("{}: {}ms", mod->getID(), static_cast<float>(took.count()) / 1000.f);
+                }
+            }
+            m_modLoadTimes.clear();
+            m_lateUnzips.clear();
             [[fallthrough]];
+        }
 
         case LoadingState::Problems:
             log::info("Finding problems");
             {
                 log::NestScope nest;
+                trace::Span span("findProblems");
                 this->findProblems();
             }
             m_loadingState = LoadingState::Done;
@@ -912,9 +1094,33 @@ void Loader::Impl::continueRefreshModGraph() {
     }
     else {
         GameEvent(GameEventType::ModsLoaded).send();
+        this->exportStartupTrace();
     }
 }
 
+void Loader::Impl::exportStartupTrace() {
+    if (!trace::isEnabled()) {
+        return;
+    }
+
+    auto tracePath = dirs::getGeodeLogDir() / "startup-trace.json";
+    if (auto res = trace::exportChromeTrace(tracePath); !res) {
+        log::warn("Failed to export startup trace: {}", res.unwrapErr());
+    }
+    else {
+        log::info("Exported startup trace to {}", tracePath);
+    }
+
+    auto summary = trace::summary();
+    if (auto res = file::writeString(dirs::getGeodeLogDir() / "startup-trace.txt", summary); !res) {
+        log::warn("Failed to write startup trace summary: {}", res.unwrapErr());
+    }
+    log::info("Startup trace summary:\n{}", summary);
+
+    // only startup gets traced, don't keep recording for the rest of the session
+    trace::disable();
+}
+
 std::vector<LoadProblem> Loader::Impl::getProblems() const {
     return m_problems;
 }
@@ -930,13 +1136,76 @@ void Loader::Impl::forceReset() {
 }
 
 bool Loader::Impl::isReadyToHook() const {
-    return m_readyToHook;
+    return m_readyToHook && m_hookBatchDepth == 0;
 }
 
 void Loader::Impl::addUninitializedHook(Hook* hook, Mod* mod) {
     m_uninitializedHooks.emplace_back(hook, mod);
 }
 
+void Loader::Impl::removeUninitializedHooks(Mod* mod) {
+    std::erase_if(m_uninitializedHooks, [mod](auto const& pair) {
+        return pair.second == mod;
+    });
+}
+
+bool Loader::Impl::removeUninitializedHook(Hook* hook) {
+    return std::erase_if(m_uninitializedHooks, [hook](auto const& pair) {
+        return pair.first == hook;
+    }) != 0;
+}
+
+void Loader::Impl::beginHookBatch() {
+    m_hookBatchDepth += 1;
+}
+
+bool Loader::Impl::endHookBatch() {
+    m_hookBatchDepth -= 1;
+    if (!this->isReadyToHook()) {
+        return true;
+    }
+    return this->enableUninitializedHooks();
+}
+
+bool Loader::Impl::enableUninitializedHooks() {
+    trace::Span span("enableHooks");
+    auto hooks = std::move(m_uninitializedHooks);
+    m_uninitializedHooks.clear();
+
+    // group hooks by target, so every handler gets created and patched in one go
+    // and the targets are visited in address order
+    std::stable_sort(hooks.begin(), hooks.end(), [](auto const& a, auto const& b) {
+        return a.first->getAddress() < b.first->getAddress();
+    });
+
+    bool hadErrors = false;
+    std::unordered_map<Mod*, size_t> enabledCounts;
+    for (auto const& [hook, mod] : hooks) {
+        auto res = hook->m_impl->enableQuietly();
+        if (!res) {
+            log::logImpl(Severity::Error, mod, "{}", res.unwrapErr());
+            hadErrors = true;
+        }
+        else if (res.unwrap()) {
+            enabledCounts[mod] += 1;
+        }
+    }
+
+    // one line per mod instead of one per hook
+    size_t total = 0;
+    for (auto const& [mod, count] : enabledCounts) {
+        total += count;
+        if (mod) {
+            log::debug("Enabled {} hooks for {}", count, mod->getID());
+        }
+        else {
+            log::debug("Enabled {} hooks", count);
+        }
+    }
+    trace::counter("hookBatchSize", total);
+    return !hadErrors;
+}
+
 static bool isPlatformBinary(std::string_view modID, std::string_view filename) {
     if (!filename.starts_with(modID)) {
         return false;
@@ -949,11 +1218,62 @@ static bool isPlatformBinary(std::string_view modID, std::string_view filename)
         || filename.ends_with(".ios.dylib");
 }
 
+// what was extracted from a .geode file last time, so updates only need to touch changed entries
+struct UnzipManifestEntry {
+    uint32_t crc32;
+    int64_t size;
+
+    bool operator==(UnzipManifestEntry const&) const = default;
+};
+using UnzipManifest = std::unordered_map<std::string, UnzipManifestEntry>;
+
+static constexpr int UNZIP_MANIFEST_VERSION = 1;
+
+static std::optional<UnzipManifest> readUnzipManifest(std::filesystem::path const& path) {
+    auto res = file::readJson(path);
+    if (!res) {
+        return std::nullopt;
+    }
+    auto json = std::move(res).unwrap();
+    if (json["version"].asInt().unwrapOr(0) != UNZIP_MANIFEST_VERSION) {
+        return std::nullopt;
+    }
+
+    UnzipManifest manifest;
+    for (auto& [key, value] : json["entries"]) {
+        auto crc = value["crc"].asUInt();
+        auto size = value["size"].asInt();
+        if (!crc || !size) {
+            return std::nullopt;
+        }
+        manifest.insert({ key, UnzipManifestEntry {
+            .crc32 = static_cast<uint32_t>(crc.unwrap()),
+            .size = size.unwrap(),
+        } });
+    }
+    return manifest;
+}
+
+static Result<> writeUnzipManifest(std::filesystem::path const& path, UnzipManifest const& manifest) {
+    auto entries = matjson::Value::object();
+    for (auto& [key, entry] : manifest) {
+        entries[key] = matjson::makeObject({
+            { "crc", entry.crc32 },
+            { "size", entry.size },
+        });
+    }
+    return file::writeStringSafe(path, matjson::makeObject({
+        { "version", UNZIP_MANIFEST_VERSION },
+        { "entries", entries },
+    }).dump(matjson::NO_INDENTATION));
+}
+
 Result<> Loader::Impl::unzipGeodeFile(ModMetadata metadata) {
     // Unzip .geode file into temp dir
     auto tempDir = dirs::getModRuntimeDir() / metadata.getID();
 
     auto datePath = tempDir / "modified-at";
+    auto manifestPath = tempDir / "unzip-manifest.json";
     std::string currentHash = file::readString(datePath).unwrapOr("");
 
     std::error_code ec;
@@ -970,40 +1290,87 @@ Result<> Loader::Impl::unzipGeodeFile(ModMetadata metadata) {
     }
     log::debug("Hash mismatch detected, unzipping");
 
-    std::filesystem::remove_all(tempDir, ec);
-    if (ec) {
-        auto message = formatSystemError(ec.value());
-        return Err("Unable to delete temp dir: " + message GEODE_WINDOWS( + " Try <cg>restarting your PC</c> to fix the issue."));
-    }
-
-    (void)utils::file::createDirectoryAll(tempDir);
-
     GEODE_UNWRAP_INTO(auto unzip, file::Unzip::create(metadata.getPath()));
     if (!unzip.hasEntry(metadata.getBinaryName())) {
         return Err(
             fmt::format("Unable to find platform binary under the name \"{}\"", metadata.getBinaryName())
         );
     }
-    GEODE_UNWRAP(unzip.extractAllTo(tempDir));
 
-    // Delete binaries for other platforms since they're pointless
-    // The if should never fail, but you never know
-    for (auto& entry : std::filesystem::directory_iterator(tempDir)) {
-        if (entry.is_directory()) {
+    // Binaries for other platforms are pointless, so they never get extracted
+    UnzipManifest manifest;
+    for (auto& entry : unzip.getEntries()) {
+        auto info = unzip.getEntryInfo(entry);
+        if (!info || info->isDirectory) {
             continue;
         }
-
-        const std::string filename = utils::string::pathToString(entry.path().filename());
-        if (metadata.getBinaryName() == filename || !isPlatformBinary(metadata.getID(), filename)) {
+        auto name = utils::string::pathToString(entry);
+        if (name != metadata.getBinaryName() && isPlatformBinary(metadata.getID(), name)) {
             continue;
         }
+        manifest.insert({ std::move(name), UnzipManifestEntry {
+            .crc32 = info->crc32,
+            .size = info->uncompressedSize,
+        } });
+    }
 
-        // The binary is not for our platform, delete!
-        // We don't really care if the deletion succeeds though.
-        std::error_code ec;
-        std::filesystem::remove(entry.path(), ec);
+    // Without a manifest from the last unzip there's no telling what's in the
+    // directory, so start over from scratch
+    auto previous = std::filesystem::exists(tempDir, ec) ? readUnzipManifest(manifestPath) : std::nullopt;
+    if (!previous) {
+        std::filesystem::remove_all(tempDir, ec);
+        if (ec) {
+            auto message = formatSystemError(ec.value());
+            return Err("Unable to delete temp dir: " + message GEODE_WINDOWS( + " Try <cg>restarting your PC</c> to fix the issue."));
+        }
+        previous.emplace();
     }
 
+    (void)utils::file::createDirectoryAll(tempDir);
+
+    // If we get interrupted halfway through, the next launch has to redo everything
+    std::filesystem::remove(manifestPath, ec);
+    std::filesystem::remove(datePath, ec);
+
+    size_t removed = 0;
+    for (auto& [name, _] : *previous) {
+        if (manifest.contains(name)) {
+            continue;
+        }
+        auto path = (tempDir / std::u8string(name.begin(), name.end())).lexically_normal();
+        // The manifest is just a file on disk, don't trust it to stay inside the temp dir
+        auto relative = path.lexically_relative(tempDir);
+        if (relative.empty() || *relative.begin() == "..") {
+            continue;
+        }
+        std::filesystem::remove(path, ec);
+        if (ec) {
+            auto message = formatSystemError(ec.value());
+            return Err(fmt::format("Unable to delete {}: {}", path, message));
+        }
+        removed++;
+    }
+
+    size_t extracted = 0;
+    GEODE_UNWRAP(unzip.extractAllTo(tempDir, [&](std::filesystem::path const& entry) {
+        auto it = manifest.find(utils::string::pathToString(entry));
+        if (it == manifest.end()) {
+            return false;
+        }
+        auto old = previous->find(it->first);
+        if (old != previous->end() && old->second == it->second) {
+            // make sure nobody deleted it in the meantime
+            std::error_code ec;
+            auto size = std::filesystem::file_size(tempDir / entry, ec);
+            if (!ec && static_cast<int64_t>(size) == it->second.size) {
+                return false;
+            }
+        }
+        extracted++;
+        return true;
+    }));
+    log::debug("Extracted {} entries and removed {} (out of {})", extracted, removed, manifest.size());
+
     // Check if there is a binary that we need to move over from the unzipped binaries dir
     if (this->isPatchless()) {
         // TODO: enable in 4.7.0
@@ -1022,6 +1389,10 @@ Result<> Loader::Impl::unzipGeodeFile(ModMetadata metadata) {
         }
     }
 
+    if (auto res = writeUnzipManifest(manifestPath, manifest); !res) {
+        log::warn("Failed to write unzip manifest of geode zip, will fully unzip next launch: {}", res.unwrapErr());
+        return Ok();
+    }
     auto res = file::writeString(datePath, modifiedHash);
     if (!res) {
         log::warn("Failed to write modified date of geode zip, will try to unzip next launch: {}", res.unwrapErr());
@@ -1051,22 +1422,18 @@ Result<> Loader::Impl::extractBinary(ModMetadata metadata) {
 }
 
 bool Loader::Impl::loadHooks() {
+    trace::Span span("loadHooks");
     m_readyToHook = true;
-    bool hadErrors = false;
-    for (auto const& [hook, mod] : m_uninitializedHooks) {
-        auto res = hook->enable();
-        if (!res) {
-            log::logImpl(Severity::Error, mod, "{}", res.unwrapErr());
-            hadErrors = true;
-        }
-    }
-    m_uninitializedHooks.clear();
-    return !hadErrors;
+    return this->enableUninitializedHooks();
 }
 
 void Loader::Impl::queueInMainThread(ScheduledFunction&& func) {
+    this->queueInMainThread(std::move(func), MainThreadPriority::Normal);
+}
+
+void Loader::Impl::queueInMainThread(ScheduledFunction&& func, MainThreadPriority priority) {
     std::lock_guard<std::mutex> lock(m_mainThreadMutex);
-    m_mainThreadQueue.push_back(std::move(func));
+    m_mainThreadQueue[static_cast<size_t>(priority)].push_back(std::move(func));
 }
 
 void Loader::Impl::executeMainThreadQueue() {
@@ -1075,22 +1442,74 @@ void Loader::Impl::executeMainThreadQueue() {
     // to prevent allocating an extra vector every frame we have a separate temp queue,
     // where we first move all functions before executing them.
     // this means there are no allocations in the common case, and we maintain deadlock safety
-    // since we do not call any functions while holding the mutex
-
-    auto& queue = m_mainThreadQueue;
-    auto& execQueue = m_mainThreadQueueExec;
-    execQueue.reserve(queue.size());
-    std::move(queue.begin(), queue.end(), std::back_inserter(execQueue));
-    queue.clear();
+    // since we do not call any functions while holding the mutex.
+    // functions that didn't fit into the last frame's budget are still at the front of it
+
+    for (size_t i = 0; i < m_mainThreadQueue.size(); i++) {
+        auto& queue = m_mainThreadQueue[i];
+        auto& execQueue = m_mainThreadQueueExec[i];
+        auto& head = m_mainThreadQueueExecHead[i];
+        if (head != 0) {
+            execQueue.erase(execQueue.begin(), execQueue.begin() + head);
+            head = 0;
+        }
+        execQueue.reserve(execQueue.size() + queue.size());
+        std::move(queue.begin(), queue.end(), std::back_inserter(execQueue));
+        queue.clear();
+    }
 
     m_mainThreadMutex.unlock();
 
-    // call all functions
-    for (auto& func : execQueue) {
-        func();
+    auto start = std::chrono::steady_clock::now();
+    auto budgetLeft = [&] {
+        return std::chrono::steady_clock::now() - start < MAIN_THREAD_QUEUE_BUDGET;
+    };
+
+    // input is never deferred, the rest always makes some progress
+    // so that nothing can get starved indefinitely
+    size_t remaining = 0;
+    for (size_t i = 0; i < m_mainThreadQueueExec.size(); i++) {
+        auto& execQueue = m_mainThreadQueueExec[i];
+        auto& head = m_mainThreadQueueExecHead[i];
+        bool budgeted = i != static_cast<size_t>(MainThreadPriority::Input);
+
+        while (head < execQueue.size()) {
+            if (budgeted && head != 0 && !budgetLeft()) {
+                break;
+            }
+            // move it out first, the function may queue more work
+            auto func = std::move(execQueue[head++]);
+            func();
+        }
+
+        if (head == execQueue.size()) {
+            execQueue.clear();
+            head = 0;
+        }
+        remaining += execQueue.size() - head;
+    }
+
+    auto micros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start
+    ).count());
+
+    std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+    auto& stats = m_mainThreadStats;
+    stats.lastFrameMicros = micros;
+    stats.longestFrameMicros = std::max(stats.longestFrameMicros, micros);
+    if (remaining != 0) {
+        stats.stalledFrames++;
+        stats.deferrals += remaining;
+    }
+    stats.pending = remaining;
+    for (auto& queue : m_mainThreadQueue) {
+        stats.pending += queue.size();
     }
+}
 
-    execQueue.clear();
+MainThreadQueueStats Loader::Impl::getMainThreadQueueStats() const {
+    std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+    return m_mainThreadStats;
 }
 
 void Loader::Impl::provideNextMod(Mod* mod) {
@@ -1184,15 +1603,13 @@ Result<tulip::hook::HandlerHandle> Loader::Impl::getHandler(void* address) {
 }
 
 Result<tulip::hook::HandlerHandle> Loader::Impl::getOrCreateHandler(void* address, tulip::hook::HandlerMetadata const& metadata) {
-    if (m_handlerHandles.count(address) && m_handlerHandles[address].second > 0) {
-        m_handlerHandles[address].second++;
-        return Ok(m_handlerHandles[address].first);
+    auto& [handle, count] = m_handlerHandles[address];
+    if (count > 0) {
+        count++;
+        return Ok(handle);
     }
-    tulip::hook::HandlerHandle handle;
     GEODE_UNWRAP_INTO(handle, tulip::hook::createHandler(address, metadata));
-
-    m_handlerHandles[address].first = handle;
-    m_handlerHandles[address].second = 1;
+    count = 1;
     return Ok(handle);
 }
 
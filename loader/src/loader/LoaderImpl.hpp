@@ -12,6 +12,7 @@
 #include <Geode/utils/StringMap.hpp>
 #include "ModImpl.hpp"
 #include <crashlog.hpp>
+#include <array>
 #include <mutex>
 #include <optional>
 #include <thread>
@@ -40,11 +41,16 @@ namespace geode {
 
         LoadingState m_loadingState = LoadingState::None;
 
-        std::vector<geode::Function<void(void)>> m_mainThreadQueue;
-        std::vector<geode::Function<void(void)>> m_mainThreadQueueExec; // see comments in loaderimpl.cpp for the purpose
+        // one queue per MainThreadPriority
+        std::array<std::vector<geode::Function<void(void)>>, 3> m_mainThreadQueue;
+        std::array<std::vector<geode::Function<void(void)>>, 3> m_mainThreadQueueExec; // see comments in loaderimpl.cpp for the purpose
+        std::array<size_t, 3> m_mainThreadQueueExecHead{};
+        MainThreadQueueStats m_mainThreadStats;
         mutable std::mutex m_mainThreadMutex;
         std::vector<std::pair<Hook*, Mod*>> m_uninitializedHooks;
         bool m_readyToHook = false;
+        // while nonzero, newly claimed hooks are collected and enabled together
+        size_t m_hookBatchDepth = 0;
 
         std::mutex m_nextModMutex;
         std::unique_lock<std::mutex> m_nextModLock = std::unique_lock<std::mutex>(m_nextModMutex, std::defer_lock);
@@ -54,10 +60,14 @@ namespace geode {
 
         Mod* m_currentlyLoadingMod = nullptr;
 
-        int m_refreshingModCount = 0;
         int m_refreshedModCount = 0;
         int m_lateRefreshedModCount = 0;
 
+        // late mods are unzipped ahead of time, nullopt while still in progress
+        std::unordered_map<Mod*, std::optional<Result<>>> m_lateUnzips;
+        size_t m_lateUnzipsInFlight = 0;
+        std::vector<std::pair<Mod*, std::chrono::microseconds>> m_modLoadTimes;
+
         utils::StringMap<std::string> m_launchArgs;
 
         std::chrono::time_point<std::chrono::high_resolution_clock> m_timerBegin;
@@ -107,9 +117,13 @@ namespace geode {
         void buildModGraph();
         void orderModStack();
         void loadModGraph(Mod* node, bool early);
+        bool shouldUnzipLate(Mod* node, bool lookahead);
+        void startLateUnzip(Mod* node);
+        void startLateUnzips();
         void findProblems();
         void refreshModGraph();
         void continueRefreshModGraph();
+        void exportStartupTrace();
 
         bool isModInstalled(std::string_view id) const;
         Mod* getInstalledMod(std::string_view id) const;
@@ -129,10 +143,17 @@ namespace geode {
         void updateResources(bool forceReload);
 
         void queueInMainThread(ScheduledFunction&& func);
+        void queueInMainThread(ScheduledFunction&& func, MainThreadPriority priority);
         void executeMainThreadQueue();
+        MainThreadQueueStats getMainThreadQueueStats() const;
 
         bool isReadyToHook() const;
         void addUninitializedHook(Hook* hook, Mod* mod);
+        void removeUninitializedHooks(Mod* mod);
+        bool removeUninitializedHook(Hook* hook);
+        void beginHookBatch();
+        bool endHookBatch();
+        bool enableUninitializedHooks();
 
         Mod* getInternalMod();
         Result<> setupInternalMod();
@@ -10,13 +10,18 @@
 #include <Geode/utils/casts.hpp>
 #include <Geode/utils/general.hpp>
 #include <Geode/utils/async.hpp>
+#include <Geode/utils/file.hpp>
+#include <Geode/utils/string.hpp>
 #include <asp/time/SystemTime.hpp>
 #include <arc/future/Select.hpp>
 #include <arc/time/Sleep.hpp>
 #include <fmt/chrono.h>
 #include <fmt/format.h>
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <ostream>
+#include <thread>
 #include <utility>
 
 using namespace geode::prelude;
@@ -24,7 +29,17 @@ using namespace geode::log;
 using namespace cocos2d;
 
 static std::atomic<bool> g_logMillis{false};
-static constexpr size_t LOG_BUFFER_LIMIT = 32768;
+// how many records the log thread decodes before writing them out
+static constexpr size_t LOG_BATCH_LIMIT = 1024;
+// how long a producer waits for room under LogOverflowPolicy::Block before giving up
+static constexpr auto LOG_BLOCK_TIMEOUT = std::chrono::milliseconds(250);
+// thread and source names are clamped so a record always has room for its content
+static constexpr size_t LOG_NAME_LIMIT = 256;
+// log files are closed and compressed once they grow past this
+static constexpr size_t LOG_ROTATE_SIZE = 16 * 1024 * 1024;
+static constexpr auto LOG_INDEX_NAME = "index.json";
+// how often the end time of the current log gets written to the index
+static constexpr auto LOG_INDEX_INTERVAL = std::chrono::seconds(10);
 
 BorrowedLog::BorrowedLog(Severity severity, int32_t nestCount, std::string_view content, std::string_view thread, std::string_view source, Mod* mod)
     : m_time(asp::SystemTime::now())
@@ -136,9 +151,18 @@ void log::vlogImpl(Severity sev, Mod* mod, fmt::string_view format, fmt::format_
         nestCount += s_nestCountOffset;
     }
 
+    // args only hold references at this point, so rejecting the log before
+    // formatting it makes filtered out logs cost almost nothing
+    auto logger = Logger::get();
+    if (!logger->shouldOutputLog(sev, mod)) return;
+
     LogImplGuard _guard;
 
-    Logger::get()->push(sev, nestCount, fmt::vformat(format, args),
+    // format into a stack buffer, the logger copies it into the thread's ring
+    fmt::memory_buffer buf;
+    fmt::vformat_to(fmt::appender(buf), format, args);
+
+    logger->push(sev, nestCount, std::string_view(buf.data(), buf.size()),
         thread::getName(), mod->getName(), mod);
 }
 
@@ -146,18 +170,179 @@ std::filesystem::path const& log::getCurrentLogPath() {
     return Logger::get()->getLogPath();
 }
 
+std::vector<std::filesystem::path> log::findLogFiles(asp::SystemTime from, asp::SystemTime to, Severity minSeverity) {
+    return Logger::get()->findLogs(from, to, minSeverity);
+}
+
 Severity Log::getSeverity() const {
     return m_severity;
 }
 
-// Logger
+// LogArchiveEntry
+
+bool LogArchiveEntry::add(BorrowedLog const& log) {
+    m_end = log.m_time;
+    auto index = static_cast<int>(log.m_severity.m_value) + 1;
+    if (index >= 0 && index < static_cast<int>(m_counts.size())) {
+        return m_counts[index]++ == 0;
+    }
+    return false;
+}
+
+bool LogArchiveEntry::hasSeverity(Severity min) const {
+    for (auto i = std::max(static_cast<int>(min.m_value) + 1, 0); i < static_cast<int>(m_counts.size()); i++) {
+        if (m_counts[i] != 0) return true;
+    }
+    return false;
+}
+
+// LogRing
+
+static_assert(std::is_trivially_copyable_v<LogRecordHeader>);
+static_assert((LogRing::WORD_COUNT & (LogRing::WORD_COUNT - 1)) == 0, "ring size must be a power of two");
+
+namespace {
+    // packs a byte stream into consecutive ring words
+    class RecordWriter {
+        std::atomic<LogRing::Word>* m_words;
+        size_t m_pos;
+        LogRing::Word m_word = 0;
+        size_t m_fill = 0;
+
+        void storeWord() {
+            m_words[m_pos++ % LogRing::WORD_COUNT].store(m_word, std::memory_order::relaxed);
+            m_word = 0;
+            m_fill = 0;
+        }
+
+    public:
+        RecordWriter(std::atomic<LogRing::Word>* words, size_t pos) : m_words(words), m_pos(pos) {}
+
+        void write(void const* data, size_t size) {
+            auto bytes = static_cast<char const*>(data);
+            while (size > 0) {
+                auto count = std::min(size, sizeof(LogRing::Word) - m_fill);
+                std::memcpy(reinterpret_cast<char*>(&m_word) + m_fill, bytes, count);
+                m_fill += count;
+                bytes += count;
+                size -= count;
+                if (m_fill == sizeof(LogRing::Word)) {
+                    this->storeWord();
+                }
+            }
+        }
+
+        void writeWord(LogRing::Word word) {
+            m_word = word;
+            this->storeWord();
+        }
+
+        void finish() {
+            if (m_fill != 0) {
+                this->storeWord();
+            }
+        }
+    };
+}
+
+LogRing::LogRing() : m_words(std::make_unique<std::atomic<Word>[]>(WORD_COUNT)) {}
 
-Logger::Logger() {
-    auto [tx, rx] = arc::mpsc::channel<Log>(LOG_BUFFER_LIMIT);
-    m_logTx = std::move(tx);
-    m_logRx = std::move(rx);
+bool LogRing::tryPush(LogRecordHeader header, std::string_view thread, std::string_view source, std::string_view content) {
+    // a single record may never take up more than a fraction of the ring
+    static constexpr size_t maxContent =
+        (MAX_RECORD_WORDS - 1) * sizeof(Word) - sizeof(LogRecordHeader) - LOG_NAME_LIMIT * 2;
+
+    thread = thread.substr(0, LOG_NAME_LIMIT);
+    source = source.substr(0, LOG_NAME_LIMIT);
+    content = content.substr(0, maxContent);
+    header.m_threadSize = static_cast<uint16_t>(thread.size());
+    header.m_sourceSize = static_cast<uint16_t>(source.size());
+    header.m_contentSize = static_cast<uint32_t>(content.size());
+
+    auto bytes = sizeof(LogRecordHeader) + thread.size() + source.size() + content.size();
+    auto words = 1 + (bytes + sizeof(Word) - 1) / sizeof(Word);
+
+    auto head = m_head.load(std::memory_order::relaxed);
+    if (head + words - m_tail.load(std::memory_order::acquire) > WORD_COUNT) {
+        return false;
+    }
+
+    // the first word of every record is its length in words
+    RecordWriter writer(m_words.get(), head);
+    writer.writeWord(words);
+    writer.write(&header, sizeof(header));
+    writer.write(thread.data(), thread.size());
+    writer.write(source.data(), source.size());
+    writer.write(content.data(), content.size());
+    writer.finish();
+
+    m_head.store(head + words, std::memory_order::release);
+    return true;
+}
+
+bool LogRing::dropOldest() {
+    auto tail = m_tail.load(std::memory_order::acquire);
+    if (tail == m_head.load(std::memory_order::relaxed)) {
+        return false;
+    }
+
+    // we wrote this record ourselves, so its length is always valid here
+    auto words = m_words[tail % WORD_COUNT].load(std::memory_order::relaxed);
+    if (m_tail.compare_exchange_strong(tail, tail + words, std::memory_order::acq_rel)) {
+        m_dropped.fetch_add(1, std::memory_order::relaxed);
+        // pairs with the fence in tryPop, a consumer that sees any of the words we're
+        // about to overwrite is guaranteed to also see the moved tail and retry
+        std::atomic_thread_fence(std::memory_order::release);
+    }
+    // if the exchange failed, the consumer just made room for us
+    return true;
+}
+
+void LogRing::countDrop() {
+    m_dropped.fetch_add(1, std::memory_order::relaxed);
+}
+
+bool LogRing::tryPop(std::vector<Word>& out) {
+    while (true) {
+        auto tail = m_tail.load(std::memory_order::acquire);
+        auto head = m_head.load(std::memory_order::acquire);
+        if (tail == head) {
+            return false;
+        }
+
+        // the producer may be overwriting this record under DropOldest
+        auto words = m_words[tail % WORD_COUNT].load(std::memory_order::relaxed);
+        if (words < 2 || words > head - tail || words > MAX_RECORD_WORDS) {
+            continue;
+        }
+
+        out.resize(words);
+        for (size_t i = 0; i < words; i++) {
+            out[i] = m_words[(tail + i) % WORD_COUNT].load(std::memory_order::relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order::acquire);
+        if (m_tail.compare_exchange_strong(tail, tail + words, std::memory_order::acq_rel)) {
+            return true;
+        }
+    }
+}
+
+size_t LogRing::takeDrops() {
+    auto dropped = m_dropped.load(std::memory_order::relaxed);
+    auto fresh = dropped - m_reportedDrops;
+    m_reportedDrops = dropped;
+    return fresh;
 }
 
+bool LogRing::empty() const {
+    return m_tail.load(std::memory_order::acquire) == m_head.load(std::memory_order::acquire);
+}
+
+// Logger
+
+Logger::Logger() {}
+
 Logger* Logger::get() {
     static Logger inst;
     return &inst;
@@ -166,24 +351,26 @@ Logger* Logger::get() {
 Logger::~Logger() {
 }
 
+std::mutex& getLogMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
 void Logger::shutdownThread() {
     auto runtime = m_runtime.upgrade();
 
     if (m_usingThread.exchange(false, std::memory_order::relaxed) && m_logThread && runtime) {
         m_cancel.cancel();
         m_logThread.blockOn();
-        for (auto& msg : m_logRx->drain()) {
-            this->outputLog(BorrowedLog(msg), true);
-        }
+        std::lock_guard g(getLogMutex());
+        while (this->drainLocked() != 0) {}
     }
 
     m_runtime = {};
-    this->flush();
-}
 
-std::mutex& getLogMutex() {
-    static std::mutex mutex;
-    return mutex;
+    std::lock_guard g(getLogMutex());
+    this->flushLocked();
+    this->indexCurrentLocked();
 }
 
 static Severity logLevelFor(std::string_view level) {
@@ -202,6 +389,16 @@ static Severity logLevelFor(std::string_view level) {
     }
 }
 
+static LogOverflowPolicy overflowPolicyFor(std::string_view policy) {
+    if (policy == "drop-oldest") {
+        return LogOverflowPolicy::DropOldest;
+    } else if (policy == "drop-newest") {
+        return LogOverflowPolicy::DropNewest;
+    } else {
+        return LogOverflowPolicy::Block;
+    }
+}
+
 void Logger::setup() {
     if (m_initialized.load(std::memory_order::acquire)) {
         return;
@@ -216,6 +413,9 @@ void Logger::setup() {
     m_fileLevel = logLevelFor(
         Mod::get()->getSettingValue<std::string_view>("file-log-level")
     );
+    m_overflowPolicy = overflowPolicyFor(
+        Mod::get()->getSettingValue<std::string_view>("log-overflow-policy")
+    );
 
     listenForSettingChanges<bool>("log-milliseconds", [](bool val) {
         g_logMillis.store(val, std::memory_order::release);
@@ -226,6 +426,9 @@ void Logger::setup() {
     listenForSettingChanges<std::string_view>("file-log-level", [this](std::string_view val) {
         m_fileLevel.store(logLevelFor(val), std::memory_order::relaxed);
     });
+    listenForSettingChanges<std::string_view>("log-overflow-policy", [this](std::string_view val) {
+        m_overflowPolicy.store(overflowPolicyFor(val), std::memory_order::relaxed);
+    });
 
     auto logDir = dirs::getGeodeLogDir();
 
@@ -235,13 +438,12 @@ void Logger::setup() {
         std::filesystem::create_directories(logDir, ec);
     }
 
-    m_logPath = logDir / log::generateLogName();
-    m_logStream = std::ofstream(m_logPath);
+    this->openLogLocked();
+    // rotated logs are compressed on the runtime
+    m_runtime = async::runtime().weakFromThis();
 
     // Logs can and will probably be added before setup() is called, so we'll write them now
-    for (Log const& log : m_logRx->drain()) {
-        this->outputLog(BorrowedLog(log), true);
-    }
+    while (this->drainLocked() != 0) {}
 
     this->flushLocked();
     m_initialized.store(true, std::memory_order::release);
@@ -250,9 +452,12 @@ void Logger::setup() {
     m_usingThread = Mod::get()->getSettingValue<bool>("log-thread");
     if (m_usingThread) {
         m_logThread = async::runtime().spawn(this->workerThread());
-        m_runtime = async::runtime().weakFromThis();
         m_logThread.setName("Geode Log Worker");
     }
+    else {
+        // pick up anything that got queued while we were draining
+        while (this->drainLocked() != 0) {}
+    }
 }
 
 arc::Future<> Logger::workerThread() {
@@ -270,28 +475,44 @@ arc::Future<> Logger::workerThread() {
 
     size_t flushRequests = 0;
 
-    while (running) {
+    // shutdownThread clears m_usingThread before cancelling, and drains whatever is left itself
+    while (running && m_usingThread.load(std::memory_order::relaxed)) {
         auto now = asp::Instant::now();
 
         if (now >= nextFlush || unflushed >= 64) {
             doFlush();
         }
 
+        size_t written;
+        {
+            std::lock_guard g(getLogMutex());
+            written = this->drainLocked();
+        }
+        unflushed += written;
+
+        // a full batch means there's probably more waiting
+        if (written == LOG_BATCH_LIMIT) {
+            continue;
+        }
+
         // if we have a flush request, only fulfill it once all logs are printed
-        if (flushRequests && m_logRx->empty()) {
+        if (flushRequests && this->ringsEmpty()) {
             doFlush();
             m_syncFlushSemaphore.release(flushRequests);
             flushRequests = 0;
         }
 
-        co_await arc::select(
-            arc::selectee(m_logRx->recv(), [&](auto res) {
-                if (!res) return;
-                Log log = std::move(res).unwrap();
+        // from here on producers have to wake us up, so check once more
+        // after announcing that in case a record slipped in
+        m_workerIdle.store(true, std::memory_order::relaxed);
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+        if (!this->ringsEmpty()) {
+            m_workerIdle.store(false, std::memory_order::relaxed);
+            continue;
+        }
 
-                std::lock_guard g(getLogMutex());
-                this->outputLog(BorrowedLog(log), true);
-            }),
+        co_await arc::select(
+            arc::selectee(m_logNotify.notified()),
 
             arc::selectee(m_cancel.waitCancelled(), [&] { running = false; }),
 
@@ -303,7 +524,156 @@ arc::Future<> Logger::workerThread() {
             // periodically flush
             arc::selectee(arc::sleepUntil(nextFlush))
         );
+        m_workerIdle.store(false, std::memory_order::relaxed);
+    }
+}
+
+LogRing& Logger::localRing() {
+    struct Holder {
+        std::shared_ptr<LogRing> m_ring;
+
+        ~Holder() {
+            // the log thread frees the ring once it has written out everything in it
+            if (m_ring) m_ring->m_detached.store(true, std::memory_order::release);
+        }
+    };
+    static thread_local Holder s_holder;
+
+    if (!s_holder.m_ring) {
+        s_holder.m_ring = std::make_shared<LogRing>();
+        std::lock_guard g(m_ringsMutex);
+        m_rings.push_back(s_holder.m_ring);
+    }
+    return *s_holder.m_ring;
+}
+
+void Logger::pushRecord(LogRecordHeader const& header, std::string_view thread, std::string_view source, std::string_view content) {
+    auto& ring = this->localRing();
+
+    // nothing is consuming before setup, so waiting for room would be pointless there,
+    // and those logs are the ones needed for debugging startup crashes
+    if (!m_initialized.load(std::memory_order::acquire)) {
+        if (!ring.tryPush(header, thread, source, content)) {
+            thread = thread.substr(0, LOG_NAME_LIMIT);
+            source = source.substr(0, LOG_NAME_LIMIT);
+
+            EarlyLog early{header, fmt::format("{}{}{}", thread, source, content)};
+            early.m_header.m_threadSize = static_cast<uint16_t>(thread.size());
+            early.m_header.m_sourceSize = static_cast<uint16_t>(source.size());
+            early.m_header.m_contentSize = static_cast<uint32_t>(content.size());
+
+            std::lock_guard g(m_ringsMutex);
+            m_earlyLogs.push_back(std::move(early));
+        }
+        return;
+    }
+
+    auto policy = m_usingThread.load(std::memory_order::relaxed)
+        ? m_overflowPolicy.load(std::memory_order::relaxed)
+        : LogOverflowPolicy::DropNewest;
+
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    while (!ring.tryPush(header, thread, source, content)) {
+        if (policy == LogOverflowPolicy::DropOldest && ring.dropOldest()) {
+            continue;
+        }
+        if (policy == LogOverflowPolicy::Block) {
+            // never wait forever, the log thread may be sharing a runtime thread with us
+            auto now = std::chrono::steady_clock::now();
+            if (!deadline) {
+                deadline = now + LOG_BLOCK_TIMEOUT;
+            }
+            if (now < *deadline) {
+                this->wakeWorker();
+                std::this_thread::yield();
+                continue;
+            }
+        }
+        // the log thread reports these in the log file
+        ring.countDrop();
+        return;
     }
+
+    this->wakeWorker();
+}
+
+void Logger::wakeWorker() {
+    // only pay for a notify when the log thread is actually waiting for one
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    if (m_workerIdle.load(std::memory_order::relaxed) && m_workerIdle.exchange(false, std::memory_order::relaxed)) {
+        m_logNotify.notifyOne(true);
+    }
+}
+
+size_t Logger::drainLocked() {
+    std::vector<std::shared_ptr<LogRing>> rings;
+    std::vector<EarlyLog> earlyLogs;
+    {
+        std::lock_guard g(m_ringsMutex);
+        rings = m_rings;
+        earlyLogs.swap(m_earlyLogs);
+        // rings of exited threads can't receive anything new, so drop them once drained
+        std::erase_if(m_rings, [](auto const& ring) {
+            return ring->m_detached.load(std::memory_order::acquire) && ring->empty();
+        });
+    }
+
+    m_batch.clear();
+    m_batchData.clear();
+
+    for (auto& early : earlyLogs) {
+        m_batch.push_back(QueuedLog{early.m_header, m_batchData.size()});
+        m_batchData.append(early.m_data);
+    }
+
+    for (auto& ring : rings) {
+        while (m_batch.size() < LOG_BATCH_LIMIT && ring->tryPop(m_scratch)) {
+            auto bytes = reinterpret_cast<char const*>(m_scratch.data() + 1);
+
+            QueuedLog log;
+            std::memcpy(&log.m_header, bytes, sizeof(LogRecordHeader));
+            log.m_offset = m_batchData.size();
+            m_batchData.append(
+                bytes + sizeof(LogRecordHeader),
+                log.m_header.m_threadSize + log.m_header.m_sourceSize + log.m_header.m_contentSize
+            );
+            ring->m_lastThread.assign(bytes + sizeof(LogRecordHeader), log.m_header.m_threadSize);
+            m_batch.push_back(log);
+        }
+    }
+
+    // every ring is in order by itself, merge them so the output is too
+    std::stable_sort(m_batch.begin(), m_batch.end(), [](QueuedLog const& a, QueuedLog const& b) {
+        return a.m_header.m_time.timeSinceEpoch().millis() < b.m_header.m_time.timeSinceEpoch().millis();
+    });
+
+    for (auto& queued : m_batch) {
+        auto& header = queued.m_header;
+        std::string_view data = m_batchData;
+        auto thread = data.substr(queued.m_offset, header.m_threadSize);
+        auto source = data.substr(queued.m_offset + header.m_threadSize, header.m_sourceSize);
+        auto content = data.substr(queued.m_offset + header.m_threadSize + header.m_sourceSize, header.m_contentSize);
+
+        BorrowedLog log(header.m_severity, header.m_nestCount, content, thread, source, header.m_mod);
+        log.m_time = header.m_time;
+        this->outputLog(log, true);
+    }
+
+    for (auto& ring : rings) {
+        if (auto dropped = ring->takeDrops()) {
+            auto content = fmt::format("Log buffer overflowed, dropped {} message{}", dropped, dropped == 1 ? "" : "s");
+            this->outputLog(BorrowedLog(Severity::Warning, 0, content, ring->m_lastThread, "Geode", nullptr), true);
+        }
+    }
+
+    return m_batch.size();
+}
+
+bool Logger::ringsEmpty() {
+    std::lock_guard g(m_ringsMutex);
+    return m_earlyLogs.empty() && std::all_of(m_rings.begin(), m_rings.end(), [](auto const& ring) {
+        return ring->empty();
+    });
 }
 
 void Logger::deleteOldLogs(size_t maxAgeHours) {
@@ -322,7 +692,8 @@ void Logger::deleteOldLogs(size_t maxAgeHours) {
 
     while (iterator != end) {
         auto& entry = *iterator;
-        if (entry.is_regular_file(ec) && entry.path().extension() == ".log") {
+        auto ext = entry.path().extension();
+        if (entry.is_regular_file(ec) && (ext == ".log" || ext == ".zip")) {
             auto time = std::filesystem::last_write_time(entry, ec);
             if (ec == std::error_code{}) {
                 auto diff = now - time;
@@ -340,6 +711,225 @@ void Logger::deleteOldLogs(size_t maxAgeHours) {
             return;
         }
     }
+
+    // forget about the files that were just deleted
+    std::lock_guard g(m_indexMutex);
+    auto merged = this->mergePendingIndexLocked();
+    auto& entries = this->loadIndexLocked();
+    auto count = entries.size();
+    std::erase_if(entries, [&](LogArchiveEntry const& entry) {
+        return !std::filesystem::exists(logDir / entry.m_file, ec);
+    });
+    if (merged || entries.size() != count) {
+        this->writeIndexLocked();
+    }
+}
+
+void Logger::compressOldLogs() {
+    auto logDir = dirs::getGeodeLogDir();
+
+    std::vector<std::filesystem::path> logs;
+    std::error_code ec;
+    for (auto& entry : std::filesystem::directory_iterator(logDir, ec)) {
+        if (entry.is_regular_file(ec) && entry.path().extension() == ".log") {
+            logs.push_back(entry.path());
+        }
+    }
+
+    std::filesystem::path current;
+    {
+        std::lock_guard g(getLogMutex());
+        current = m_logPath;
+    }
+
+    for (auto& path : logs) {
+        if (path.filename() == current.filename()) continue;
+        if (auto res = this->compressLog(path); !res) {
+            log::warn("Failed to compress {}: {}", utils::string::pathToString(path.filename()), res.unwrapErr());
+        }
+    }
+}
+
+std::vector<std::filesystem::path> Logger::findLogs(asp::SystemTime from, asp::SystemTime to, Severity minSeverity) {
+    std::optional<LogArchiveEntry> current;
+    {
+        std::lock_guard g(getLogMutex());
+        current = m_current;
+    }
+    std::vector<LogArchiveEntry> entries;
+    {
+        std::lock_guard g(m_indexMutex);
+        this->mergePendingIndexLocked();
+        entries = this->loadIndexLocked();
+    }
+    if (current) {
+        std::erase_if(entries, [&](auto const& entry) { return entry.m_file == current->m_file; });
+        entries.push_back(*current);
+    }
+
+    auto fromSecs = from.timeSinceEpoch().seconds();
+    auto toSecs = to.timeSinceEpoch().seconds();
+    auto logDir = dirs::getGeodeLogDir();
+
+    std::vector<std::filesystem::path> found;
+    for (auto& entry : entries) {
+        if (entry.m_end.timeSinceEpoch().seconds() < fromSecs) continue;
+        if (entry.m_start.timeSinceEpoch().seconds() > toSecs) continue;
+        if (!entry.hasSeverity(minSeverity)) continue;
+        found.push_back(logDir / entry.m_file);
+    }
+    return found;
+}
+
+void Logger::openLogLocked() {
+    auto logDir = dirs::getGeodeLogDir();
+
+    // rotation can happen more than once a second
+    auto name = log::generateLogName();
+    auto path = logDir / name;
+    for (size_t i = 1; std::filesystem::exists(path); i++) {
+        path = logDir / fmt::format("{} ({}).log", utils::string::pathToString(std::filesystem::path(name).stem()), i);
+    }
+
+    m_logPath = path;
+    m_logStream = std::ofstream(m_logPath);
+    m_logSize = 0;
+    m_current = LogArchiveEntry {
+        .m_file = utils::string::pathToString(m_logPath.filename()),
+        .m_start = asp::SystemTime::now(),
+        .m_end = asp::SystemTime::now(),
+    };
+    // index it right away, so a session that crashes can still be found
+    this->indexCurrentLocked();
+}
+
+void Logger::rotateLocked() {
+    this->flushLocked();
+    m_logStream.close();
+    this->indexCurrentLocked();
+
+    if (auto runtime = m_runtime.upgrade()) {
+        runtime->spawnBlocking<void>([path = m_logPath] {
+            auto logger = Logger::get();
+            if (auto res = logger->compressLog(path); !res) {
+                log::warn("Failed to compress {}: {}", utils::string::pathToString(path.filename()), res.unwrapErr());
+            }
+        });
+    }
+    // otherwise compressOldLogs picks it up on the next launch
+
+    this->openLogLocked();
+}
+
+void Logger::indexCurrentLocked() {
+    if (!m_current) return;
+    m_indexedAt = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard g(m_pendingIndexMutex);
+        std::erase_if(m_pendingIndex, [&](auto const& entry) { return entry.m_file == m_current->m_file; });
+        m_pendingIndex.push_back(*m_current);
+    }
+
+    // the file is written from the blocking pool, like rotated logs are compressed,
+    // unless there's no runtime yet (or anymore) to do it
+    auto runtime = m_runtime.upgrade();
+    if (!runtime) {
+        this->writePendingIndex();
+    }
+    else if (!m_indexQueued.exchange(true)) {
+        runtime->spawnBlocking<void>([] {
+            Logger::get()->writePendingIndex();
+        });
+    }
+}
+
+void Logger::writePendingIndex() {
+    m_indexQueued.store(false);
+    std::lock_guard g(m_indexMutex);
+    if (this->mergePendingIndexLocked()) {
+        this->writeIndexLocked();
+    }
+}
+
+Result<> Logger::compressLog(std::filesystem::path const& path) {
+    // the rotation task and compressOldLogs may both pick up the same file
+    auto name = utils::string::pathToString(path.filename());
+    {
+        std::lock_guard g(m_indexMutex);
+        if (!m_compressing.insert(name).second) {
+            return Ok();
+        }
+    }
+
+    auto res = std::filesystem::exists(path) ? this->archiveLog(path) : Ok();
+
+    std::lock_guard g(m_indexMutex);
+    m_compressing.erase(name);
+    return res;
+}
+
+Result<> Logger::archiveLog(std::filesystem::path const& path) {
+    auto zipPath = std::filesystem::path(path).replace_extension(".zip");
+    auto res = file::Zip::create(zipPath).andThen([&](auto&& zip) {
+        return zip.addFrom(path);
+    });
+
+    std::error_code ec;
+    if (!res) {
+        std::filesystem::remove(zipPath, ec);
+        return res;
+    }
+    std::filesystem::remove(path, ec);
+
+    // point the index at the archive. the last summary of the file may still be
+    // pending, and merging it later would point the index back at the deleted log
+    auto name = utils::string::pathToString(path.filename());
+    std::lock_guard g(m_indexMutex);
+    auto changed = this->mergePendingIndexLocked();
+    for (auto& entry : this->loadIndexLocked()) {
+        if (entry.m_file == name) {
+            entry.m_file = utils::string::pathToString(zipPath.filename());
+            changed = true;
+            break;
+        }
+    }
+    if (changed) {
+        this->writeIndexLocked();
+    }
+    return Ok();
+}
+
+// Must be called with m_indexMutex held
+std::vector<LogArchiveEntry>& Logger::loadIndexLocked() {
+    if (!m_index) {
+        auto json = file::readJson(dirs::getGeodeLogDir() / LOG_INDEX_NAME);
+        m_index = json ? json.unwrap().as<std::vector<LogArchiveEntry>>().unwrapOrDefault() : std::vector<LogArchiveEntry>{};
+    }
+    return *m_index;
+}
+
+// Must be called with m_indexMutex held, returns whether anything was merged
+bool Logger::mergePendingIndexLocked() {
+    std::vector<LogArchiveEntry> pending;
+    {
+        std::lock_guard g(m_pendingIndexMutex);
+        pending.swap(m_pendingIndex);
+    }
+    if (pending.empty()) return false;
+
+    auto& entries = this->loadIndexLocked();
+    for (auto& summary : pending) {
+        std::erase_if(entries, [&](auto const& entry) { return entry.m_file == summary.m_file; });
+        entries.push_back(std::move(summary));
+    }
+    return true;
+}
+
+// Must be called with m_indexMutex held
+void Logger::writeIndexLocked() {
+    matjson::Value json = this->loadIndexLocked();
+    (void) file::writeStringSafe(dirs::getGeodeLogDir() / LOG_INDEX_NAME, json.dump(matjson::NO_INDENTATION));
 }
 
 Severity Logger::getConsoleLogLevel() {
@@ -350,24 +940,17 @@ Severity Logger::getFileLogLevel() {
     return m_fileLevel.load(std::memory_order::relaxed);
 }
 
-void Logger::push(Severity sev, int32_t nestCount, std::string content,
+void Logger::push(Severity sev, int32_t nestCount, std::string_view content,
     std::string_view thread, std::string_view source, Mod* mod)
 {
-    // check if we should log at all, before acquiring any locks,
-    // since this check is much cheaper than locking or pushing to queue
-    if (!this->shouldOutputLog(sev, mod)) return;
-
     // if thread is enabled or logging isn't initialized, push into the queue; otherwise print right now
     if (!m_initialized.load(std::memory_order::relaxed) || m_usingThread.load(std::memory_order::relaxed)) {
-        (void) m_logTx->trySend(Log{
-            asp::SystemTime::now(),
-            sev,
-            nestCount,
-            std::move(content),
-            std::string(thread),
-            std::string(source),
-            mod
-        });
+        this->pushRecord(LogRecordHeader{
+            .m_time = asp::SystemTime::now(),
+            .m_mod = mod,
+            .m_severity = sev,
+            .m_nestCount = nestCount,
+        }, thread, source, content);
         return;
     }
 
@@ -400,8 +983,16 @@ void Logger::outputLog(BorrowedLog const& log, bool dontFlush) {
     }
     if (logFile && logModLevel) {
         m_logStream << buf.view() << '\n';
+        // a new severity is what searches filter by, so don't wait for the next periodic update
+        if (m_current && m_current->add(log)) {
+            this->indexCurrentLocked();
+        }
+        m_logSize += buf.view().size() + 1;
+        if (m_logSize >= LOG_ROTATE_SIZE) {
+            this->rotateLocked();
+        }
         // don't flush stream for every log as that's super slow
-        if (!dontFlush) {
+        else if (!dontFlush) {
             this->flushLocked();
         }
     }
@@ -419,7 +1010,8 @@ bool Logger::shouldOutputLog(Severity sev, Mod* mod) {
 bool Logger::shouldOutputLog(Severity sev, Mod* mod, bool& console, bool& file, bool& listeners, bool& modLevel) {
     console = sev >= this->getConsoleLogLevel();
     file = sev >= this->getFileLogLevel();
-    listeners = LogEvent().getReceiverCount() > 0;
+    // don't look up the port on every log, the presence flag is enough
+    listeners = LogEvent::hasListeners();
     modLevel = !mod || (mod->isLoggingEnabled() && sev >= mod->getLogLevel());
 
     // always output the log if there are registered listeners, let them handle filtering
@@ -434,6 +1026,9 @@ void Logger::flush() {
 
 void Logger::flushLocked() {
     m_logStream << std::flush;
+    if (m_current && std::chrono::steady_clock::now() - m_indexedAt >= LOG_INDEX_INTERVAL) {
+        this->indexCurrentLocked();
+    }
 }
 
 void Logger::flushExternal() {
@@ -449,7 +1044,12 @@ void Logger::flushExternal() {
 }
 
 void Logger::clear() {
-    m_logRx->drain();
+    std::lock_guard g(getLogMutex());
+    std::lock_guard g2(m_ringsMutex);
+    for (auto& ring : m_rings) {
+        while (ring->tryPop(m_scratch)) {}
+        ring->takeDrops();
+    }
 }
 
 Nest::Nest(std::shared_ptr<Nest::Impl> impl) : m_impl(std::move(impl)) { }
@@ -4,11 +4,16 @@
 #include <Geode/loader/Log.hpp>
 #include <Geode/loader/Mod.hpp>
 #include <Geode/loader/Types.hpp>
+#include <matjson.hpp>
 #include <arc/task/Task.hpp>
 #include <arc/sync/mpsc.hpp>
 #include <arc/task/CancellationToken.hpp>
+#include <array>
 #include <vector>
+#include <memory>
+#include <mutex>
 #include <deque>
+#include <unordered_set>
 #include <thread>
 #include <fstream>
 #include <string>
@@ -38,13 +43,113 @@ namespace geode::log {
         Severity getSeverity() const;
     };
 
+    enum class LogOverflowPolicy {
+        // wait up to LOG_BLOCK_TIMEOUT for the log thread to make room, then count a drop
+        Block,
+        // overwrite the oldest records that haven't been written yet
+        DropOldest,
+        // discard the incoming record
+        DropNewest,
+    };
+
+    struct LogRecordHeader {
+        asp::SystemTime m_time;
+        Mod* m_mod;
+        Severity m_severity;
+        int32_t m_nestCount;
+        uint32_t m_contentSize = 0;
+        uint16_t m_threadSize = 0;
+        uint16_t m_sourceSize = 0;
+    };
+
+    /// A fixed size ring of encoded log records. Every thread that logs owns one,
+    /// and only a single consumer (the log thread, or setup/shutdown while it's not running)
+    /// ever reads from it. Records are stored in atomic words so that the consumer can
+    /// detect and discard records that were overwritten while it was copying them.
+    class LogRing final {
+    public:
+        using Word = uintptr_t;
+        static constexpr size_t WORD_COUNT = 8192;
+        static constexpr size_t MAX_RECORD_WORDS = WORD_COUNT / 4;
+
+        LogRing();
+
+        // producer side
+        bool tryPush(LogRecordHeader header, std::string_view thread, std::string_view source, std::string_view content);
+        bool dropOldest();
+        void countDrop();
+
+        // consumer side
+        bool tryPop(std::vector<Word>& out);
+        size_t takeDrops();
+        bool empty() const;
+
+        std::atomic<bool> m_detached = false;
+        std::string m_lastThread;
+
+    private:
+        std::unique_ptr<std::atomic<Word>[]> m_words;
+        std::atomic<size_t> m_head = 0;
+        std::atomic<size_t> m_tail = 0;
+        std::atomic<size_t> m_dropped = 0;
+        size_t m_reportedDrops = 0;
+    };
+
+    /// Summary of a single log file, kept in the log directory's index so that logs
+    /// can be searched by time and severity without opening (or decompressing) them
+    struct LogArchiveEntry {
+        std::string m_file;
+        asp::SystemTime m_start;
+        asp::SystemTime m_end;
+        // amount of logs per severity, from trace to error
+        std::array<uint64_t, 5> m_counts{};
+
+        /// Returns true if this is the first log of its severity
+        bool add(BorrowedLog const& log);
+        bool hasSeverity(Severity min) const;
+    };
+
     class Logger {
     private:
-        std::optional<arc::mpsc::Sender<Log>> m_logTx;
-        std::optional<arc::mpsc::Receiver<Log>> m_logRx;
+        struct QueuedLog {
+            LogRecordHeader m_header;
+            size_t m_offset;
+        };
+
+        std::mutex m_ringsMutex;
+        std::vector<std::shared_ptr<LogRing>> m_rings;
+        std::atomic<LogOverflowPolicy> m_overflowPolicy{LogOverflowPolicy::Block};
+        std::atomic<bool> m_workerIdle = false;
+        arc::Notify m_logNotify;
+        // only touched by the consumer, with the log mutex held
+        std::vector<LogRing::Word> m_scratch;
+        std::vector<QueuedLog> m_batch;
+        std::string m_batchData;
+        // records that didn't fit into their ring before setup. nothing drains the
+        // rings until then, so these are kept in full instead of being dropped
+        struct EarlyLog {
+            LogRecordHeader m_header;
+            std::string m_data;
+        };
+        std::vector<EarlyLog> m_earlyLogs;
+
         std::atomic<bool> m_initialized = false;
         std::ofstream m_logStream;
         std::filesystem::path m_logPath;
+        // size and summary of the file currently being written
+        size_t m_logSize = 0;
+        std::optional<LogArchiveEntry> m_current;
+        std::chrono::steady_clock::time_point m_indexedAt;
+        std::mutex m_indexMutex;
+        // the index file's contents, read once and then kept up to date. guarded by m_indexMutex
+        std::optional<std::vector<LogArchiveEntry>> m_index;
+        // files currently being compressed, guarded by m_indexMutex
+        std::unordered_set<std::string> m_compressing;
+        // summaries of the current file waiting to be merged into the index. the log
+        // mutex is held while adding to these, so they don't wait on m_indexMutex
+        std::mutex m_pendingIndexMutex;
+        std::vector<LogArchiveEntry> m_pendingIndex;
+        std::atomic<bool> m_indexQueued = false;
         std::atomic<Severity> m_consoleLevel{Severity::Debug};
         std::atomic<Severity> m_fileLevel{Severity::Debug};
 
@@ -59,12 +164,29 @@ namespace geode::log {
         ~Logger();
 
         arc::Future<> workerThread();
+
+        LogRing& localRing();
+        void pushRecord(LogRecordHeader const& header, std::string_view thread, std::string_view source, std::string_view content);
+        void wakeWorker();
+        size_t drainLocked();
+        bool ringsEmpty();
+
+        void openLogLocked();
+        void rotateLocked();
+        void indexCurrentLocked();
+        Result<> compressLog(std::filesystem::path const& path);
+        Result<> archiveLog(std::filesystem::path const& path);
+        void writePendingIndex();
+        std::vector<LogArchiveEntry>& loadIndexLocked();
+        bool mergePendingIndexLocked();
+        void writeIndexLocked();
     public:
         static Logger* get();
 
         void setup();
 
-        void push(Severity sev, int32_t nestCount, std::string content, std::string_view thread, std::string_view source, Mod* mod);
+        // callers check shouldOutputLog first, so filtered out logs never get formatted
+        void push(Severity sev, int32_t nestCount, std::string_view content, std::string_view thread, std::string_view source, Mod* mod);
 
         Severity getConsoleLogLevel();
         Severity getFileLogLevel();
@@ -79,6 +201,13 @@ namespace geode::log {
             this->deleteOldLogs(std::chrono::duration_cast<std::chrono::hours>(maxAge).count());
         }
 
+        /// Compresses logs left behind by previous sessions
+        void compressOldLogs();
+
+        /// Returns every indexed log file that overlaps the given time range and
+        /// contains at least one log of the given severity or higher
+        std::vector<std::filesystem::path> findLogs(asp::SystemTime from, asp::SystemTime to, Severity minSeverity);
+
         void shutdownThread();
         void flush();
         void outputLog(BorrowedLog const& log, bool dontFlush = false);
@@ -95,3 +224,31 @@ namespace geode::log {
         Impl(int32_t nestLevel, int32_t nestCountOffset);
     };
 }
+
+template <>
+struct matjson::Serialize<geode::log::LogArchiveEntry> {
+    static Value toJson(geode::log::LogArchiveEntry const& value) {
+        auto counts = matjson::Value::array();
+        for (auto count : value.m_counts) {
+            counts.push(count);
+        }
+        return matjson::makeObject({
+            { "file", value.m_file },
+            { "start", value.m_start.timeSinceEpoch().seconds() },
+            { "end", value.m_end.timeSinceEpoch().seconds() },
+            { "counts", counts },
+        });
+    }
+    static geode::Result<geode::log::LogArchiveEntry> fromJson(Value const& value) {
+        geode::log::LogArchiveEntry entry {
+            .m_file = GEODE_UNWRAP(value["file"].asString()),
+            .m_start = asp::SystemTime::fromUnix(GEODE_UNWRAP(value["start"].asUInt())),
+            .m_end = asp::SystemTime::fromUnix(GEODE_UNWRAP(value["end"].asUInt())),
+        };
+        auto counts = GEODE_UNWRAP(value["counts"].asArray());
+        for (size_t i = 0; i < counts.size() && i < entry.m_counts.size(); i++) {
+            entry.m_counts[i] = counts[i].asUInt().unwrapOr(0);
+        }
+        return geode::Ok(std::move(entry));
+    }
+};
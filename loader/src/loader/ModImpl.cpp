@@ -3,6 +3,7 @@
 #include "ModMetadataImpl.hpp"
 #include "HookImpl.hpp"
 #include "PatchImpl.hpp"
+#include "Tracing.hpp"
 #include "about.hpp"
 #include "console.hpp"
 
@@ -315,6 +316,8 @@ bool Mod::Impl::getLaunchFlag(std::string_view name) const {
 // Loading, Toggling, Installing
 
 Result<> Mod::Impl::loadBinary() {
+    trace::Span span("loadBinary", m_self);
+
     if (!this->isInternal() && LoaderImpl::get()->isSafeMode()) {
         // pretend to have loaded the mod, so that it still shows up on the mod list properly,
         // while the user can still toggle/uninstall it
@@ -342,10 +345,14 @@ Result<> Mod::Impl::loadBinary() {
 
     m_loaded = true;
     m_isCurrentlyLoading = true;
+    // hooks the mod claims while its binary is loading are enabled all at once afterwards
+    LoaderImpl::get()->beginHookBatch();
     auto res = this->loadPlatformBinary();
     if (!res) {
         // disable hooks/patches the mod managed to register before failure
         // note that this will not save from any other side effects (i.e. registering an event listener)
+        LoaderImpl::get()->removeUninitializedHooks(m_self);
+        LoaderImpl::get()->endHookBatch();
         for (auto patch : m_patches) { (void) patch->disable(); }
         for (auto hook : m_hooks) { (void) hook->disable(); }
         m_patches.clear();
@@ -359,6 +366,10 @@ Result<> Mod::Impl::loadBinary() {
         return res;
     }
 
+    if (!LoaderImpl::get()->endHookBatch()) {
+        log::error("Failed to enable some hooks for mod {}, see console for details", m_metadata.getID());
+    }
+
     LoaderImpl::get()->releaseNextMod();
 
     ModStateEvent(ModEventType::Loaded, std::move(m_self)).send();
@@ -546,6 +557,10 @@ Result<> Mod::Impl::disownHook(Hook* hook) {
     auto sharedHook = *foundIt;
     m_hooks.erase(foundIt);
 
+    // claimed while the binary was loading, so it was never enabled
+    if (LoaderImpl::get()->removeUninitializedHook(hook))
+        return Ok();
+
     if (!this->isLoaded() || !sharedHook->getAutoEnable())
         return Ok();
 
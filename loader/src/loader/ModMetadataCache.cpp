@@ -0,0 +1,165 @@
+#include "ModMetadataCache.hpp"
+
+#include <Geode/utils/file.hpp>
+#include <about.hpp>
+#include <cstring>
+
+using namespace geode::prelude;
+
+// bump whenever the layout below changes
+static constexpr uint32_t CACHE_FORMAT_VERSION = 1;
+static constexpr char CACHE_MAGIC[4] = { 'G', 'M', 'M', 'C' };
+
+namespace {
+    class CacheWriter {
+        ByteVector m_data;
+
+    public:
+        template <class T> requires std::is_trivially_copyable_v<T>
+        void write(T value) {
+            auto bytes = reinterpret_cast<uint8_t const*>(&value);
+            m_data.insert(m_data.end(), bytes, bytes + sizeof(T));
+        }
+
+        void writeString(std::string_view str) {
+            this->write<uint64_t>(str.size());
+            m_data.insert(m_data.end(), str.begin(), str.end());
+        }
+
+        void writeOptionalString(std::optional<std::string> const& str) {
+            this->write<uint8_t>(str.has_value());
+            if (str) {
+                this->writeString(*str);
+            }
+        }
+
+        ByteVector const& data() const {
+            return m_data;
+        }
+    };
+
+    class CacheReader {
+        ByteVector const& m_data;
+        size_t m_offset = 0;
+
+    public:
+        CacheReader(ByteVector const& data) : m_data(data) {}
+
+        template <class T> requires std::is_trivially_copyable_v<T>
+        Result<T> read() {
+            if (m_data.size() - m_offset < sizeof(T)) {
+                return Err("Unexpected end of cache");
+            }
+            T value;
+            std::memcpy(&value, m_data.data() + m_offset, sizeof(T));
+            m_offset += sizeof(T);
+            return Ok(value);
+        }
+
+        Result<std::string> readString() {
+            GEODE_UNWRAP_INTO(auto size, this->read<uint64_t>());
+            if (m_data.size() - m_offset < size) {
+                return Err("Unexpected end of cache");
+            }
+            std::string str(reinterpret_cast<char const*>(m_data.data() + m_offset), size);
+            m_offset += size;
+            return Ok(std::move(str));
+        }
+
+        Result<std::optional<std::string>> readOptionalString() {
+            GEODE_UNWRAP_INTO(auto present, this->read<uint8_t>());
+            if (!present) {
+                return Ok(std::nullopt);
+            }
+            GEODE_UNWRAP_INTO(auto str, this->readString());
+            return Ok(std::move(str));
+        }
+    };
+
+    // the cache is only valid for the loader build that wrote it, since parsing may change between them
+    std::string cacheStamp() {
+        return fmt::format("{}-{}", about::getLoaderVersionStr(), about::getLoaderCommitHash());
+    }
+}
+
+ModMetadataCache ModMetadataCache::load(std::filesystem::path const& path) {
+    ModMetadataCache cache;
+
+    auto data = file::readBinary(path);
+    if (!data) {
+        return cache;
+    }
+
+    auto res = [&]() -> Result<> {
+        CacheReader reader(data.unwrap());
+        for (char c : CACHE_MAGIC) {
+            if (GEODE_UNWRAP(reader.read<char>()) != c) {
+                return Err("Invalid magic");
+            }
+        }
+        if (GEODE_UNWRAP(reader.read<uint32_t>()) != CACHE_FORMAT_VERSION) {
+            return Err("Outdated format");
+        }
+        if (GEODE_UNWRAP(reader.readString()) != cacheStamp()) {
+            return Err("Written by a different loader");
+        }
+
+        auto count = GEODE_UNWRAP(reader.read<uint64_t>());
+        for (uint64_t i = 0; i < count; i++) {
+            auto key = GEODE_UNWRAP(reader.readString());
+            Entry entry;
+            entry.size = GEODE_UNWRAP(reader.read<uint64_t>());
+            entry.modifiedTime = GEODE_UNWRAP(reader.read<int64_t>());
+            entry.contents.modJson = GEODE_UNWRAP(reader.readString());
+            entry.contents.details = GEODE_UNWRAP(reader.readOptionalString());
+            entry.contents.changelog = GEODE_UNWRAP(reader.readOptionalString());
+            entry.contents.supportInfo = GEODE_UNWRAP(reader.readOptionalString());
+            cache.m_entries.insert({ std::move(key), std::move(entry) });
+        }
+        return Ok();
+    }();
+
+    if (!res) {
+        log::debug("Ignoring mod metadata cache: {}", res.unwrapErr());
+        cache.m_entries.clear();
+    }
+    return cache;
+}
+
+Result<> ModMetadataCache::save(std::filesystem::path const& path) const {
+    CacheWriter writer;
+    for (char c : CACHE_MAGIC) {
+        writer.write(c);
+    }
+    writer.write(CACHE_FORMAT_VERSION);
+    writer.writeString(cacheStamp());
+
+    writer.write<uint64_t>(m_entries.size());
+    for (auto& [key, entry] : m_entries) {
+        writer.writeString(key);
+        writer.write(entry.size);
+        writer.write(entry.modifiedTime);
+        writer.writeString(entry.contents.modJson);
+        writer.writeOptionalString(entry.contents.details);
+        writer.writeOptionalString(entry.contents.changelog);
+        writer.writeOptionalString(entry.contents.supportInfo);
+    }
+
+    return file::writeBinarySafe(path, writer.data());
+}
+
+ModMetadataCache::Entry const* ModMetadataCache::find(std::string const& key, uint64_t size, int64_t modifiedTime) const {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end() || it->second.size != size || it->second.modifiedTime != modifiedTime) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void ModMetadataCache::insert(std::string key, Entry entry) {
+    m_entries.insert_or_assign(std::move(key), std::move(entry));
+}
+
+size_t ModMetadataCache::size() const {
+    return m_entries.size();
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "ModMetadataImpl.hpp"
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+namespace geode {
+    /// Remembers what was read out of every .geode package on the last launch, keyed by
+    /// path, file size and modification time, so that unchanged packages don't need to be
+    /// opened again on the next one
+    class ModMetadataCache final {
+    public:
+        struct Entry {
+            uint64_t size = 0;
+            int64_t modifiedTime = 0;
+            ModMetadataImpl::PackageContents contents;
+        };
+
+        static ModMetadataCache load(std::filesystem::path const& path);
+        Result<> save(std::filesystem::path const& path) const;
+
+        Entry const* find(std::string const& key, uint64_t size, int64_t modifiedTime) const;
+        void insert(std::string key, Entry entry);
+        size_t size() const;
+
+    private:
+        std::unordered_map<std::string, Entry> m_entries;
+    };
+}
@@ -800,41 +800,46 @@ ModMetadata ModMetadata::Impl::createInvalidMetadata(
     v.m_impl->m_path = path;
     return v;
 }
-ModMetadata ModMetadata::createFromGeodeFile(std::filesystem::path const& path) {
-    // result code looks weird when you don't want to return a result
-
+std::optional<std::string> ModMetadata::Impl::guessIDFromPath(std::filesystem::path const& path) {
     // Try guess ID from filename (since usually Geode mods are named `mod.id.geode`)
-    std::optional<std::string> guessedID = utils::string::pathToString(path.stem());
-    if (!ModMetadata::validateID(*guessedID)) {
-        guessedID = std::nullopt;
-    }
-
-    // Attempt to unzip, otherwise return invalid mod with unzip error
-    auto r = file::Unzip::create(path);
-    if (!r) {
-        return Impl::createInvalidMetadata(path, r.unwrapErr(), guessedID);
+    auto guessedID = utils::string::pathToString(path.stem());
+    if (!ModMetadata::validateID(guessedID)) {
+        return std::nullopt;
     }
+    return guessedID;
+}
 
-    auto&& unzip = std::move(r.unwrap());
-
-    /// Extract mod.json from the zip and parse it
+Result<ModMetadata::Impl::PackageContents> ModMetadata::Impl::readPackage(std::filesystem::path const& path) {
+    GEODE_UNWRAP_INTO(auto unzip, file::Unzip::create(path));
 
     // First check if mod.json exists for a nicer error
     if (!unzip.hasEntry("mod.json")) {
-        return Impl::createInvalidMetadata(path, "Geode package is missing \"mod.json\"", guessedID);
+        return Err("Geode package is missing \"mod.json\"");
     }
 
-    // Extract file
-    auto modJsonDataRes = unzip.extract("mod.json").mapErr([](auto const& err) {
+    GEODE_UNWRAP_INTO(auto modJsonData, unzip.extract("mod.json").mapErr([](auto const& err) {
         return fmt::format("Unable to extract mod.json: {}", err);
-    });
-    if (!modJsonDataRes) {
-        return Impl::createInvalidMetadata(path, modJsonDataRes.unwrapErr(), guessedID);
+    }));
+
+    PackageContents contents;
+    contents.modJson = std::string(modJsonData.begin(), modJsonData.end());
+
+    Impl special;
+    if (auto res = special.addSpecialFiles(unzip); !res) {
+        contents.specialFilesError = res.unwrapErr();
     }
-    auto&& modJsonData = std::move(modJsonDataRes.unwrap());
+    contents.details = std::move(special.m_details);
+    contents.changelog = std::move(special.m_changelog);
+    contents.supportInfo = std::move(special.m_supportInfo);
+
+    return Ok(std::move(contents));
+}
+
+ModMetadata ModMetadata::Impl::createFromPackage(std::filesystem::path const& path, PackageContents const& contents) {
+    auto guessedID = guessIDFromPath(path);
 
     // Parse the JSON
-    auto modJsonRes = matjson::parse(std::string(modJsonData.begin(), modJsonData.end()))
+    auto modJsonRes = matjson::parse(contents.modJson)
         .mapErr([](auto const& err) {
             return fmt::format("Unable to parse mod.json: {}", err);
         });
@@ -845,14 +850,25 @@ ModMetadata ModMetadata::createFromGeodeFile(std::filesystem::path const& path)
 
     auto info = Impl::parse(modJson, guessedID);
     info.m_impl->m_path = path;
+    info.m_impl->m_details = contents.details;
+    info.m_impl->m_changelog = contents.changelog;
+    info.m_impl->m_supportInfo = contents.supportInfo;
 
-    auto specialFilesRes = info.m_impl->addSpecialFiles(unzip);
-    if (!specialFilesRes) {
-        info.m_impl->m_errors.emplace_back(fmt::format("Unable to add extra files: {}", specialFilesRes.unwrapErr()));
+    if (contents.specialFilesError) {
+        info.m_impl->m_errors.emplace_back(fmt::format("Unable to add extra files: {}", *contents.specialFilesError));
     }
 
     return info;
 }
+
+ModMetadata ModMetadata::createFromGeodeFile(std::filesystem::path const& path) {
+    // Attempt to unzip, otherwise return invalid mod with unzip error
+    auto contents = Impl::readPackage(path);
+    if (!contents) {
+        return Impl::createInvalidMetadata(path, contents.unwrapErr(), Impl::guessIDFromPath(path));
+    }
+    return Impl::createFromPackage(path, contents.unwrap());
+}
 ModMetadata ModMetadata::create(ModJson const& json) {
     return Impl::parse(json, std::nullopt);
 }
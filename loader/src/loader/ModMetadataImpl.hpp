@@ -112,8 +112,21 @@ namespace geode {
 
         bool operator==(ModMetadata::Impl const& other) const;
 
+        /// Everything a ModMetadata is built from, as read out of a .geode package
+        struct PackageContents {
+            std::string modJson;
+            std::optional<std::string> details;
+            std::optional<std::string> changelog;
+            std::optional<std::string> supportInfo;
+            std::optional<std::string> specialFilesError;
+        };
+
         static bool validateID(std::string_view id);
 
+        static std::optional<std::string> guessIDFromPath(std::filesystem::path const& path);
+        static Result<PackageContents> readPackage(std::filesystem::path const& path);
+        static ModMetadata createFromPackage(std::filesystem::path const& path, PackageContents const& contents);
+
         static ModMetadata parse(ModJson const& rawJson, std::optional<std::string_view> guessedID);
         static ModMetadata createInvalidMetadata(
             std::filesystem::path const& path,
@@ -12,13 +12,19 @@ namespace geode {
             return cocos2d::ccScriptType::kScriptTypeJavascript;
         }
         
+        // these run for every node in the scene, so skip building the event
+        // entirely if nobody is listening
         int executeNodeEvent(CCNode* node, int action) {
-            NodeEvent(node, static_cast<NodeEventType>(action)).send();
+            if (NodeEvent::hasListeners()) {
+                NodeEvent(node, static_cast<NodeEventType>(action)).send();
+            }
             return -1;
         }
 
         int executeMenuItemEvent(CCMenuItem* menuItem) {
-            MenuItemActivatedEvent(menuItem).send(menuItem);
+            if (MenuItemActivatedEvent::hasListeners()) {
+                MenuItemActivatedEvent(menuItem).send(menuItem);
+            }
             return -1;
         }
 
@@ -0,0 +1,242 @@
+#include "Tracing.hpp"
+
+#include <Geode/loader/Mod.hpp>
+#include <Geode/utils/file.hpp>
+#include <Geode/utils/general.hpp>
+#include <algorithm>
+#include <atomic>
+#include <matjson.hpp>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace geode::prelude;
+
+namespace {
+    struct TraceEvent {
+        std::string name;
+        std::string mod;
+        int64_t begin;
+        // duration for spans, value for counters
+        int64_t value;
+        bool isCounter;
+        // whether this is the outermost span for its mod on this thread,
+        // so nested spans aren't counted twice in the summary
+        bool isModRoot;
+    };
+
+    // every thread records into its own buffer, the mutex is only ever
+    // contended while exporting
+    struct ThreadBuffer {
+        std::mutex mutex;
+        uint32_t id;
+        std::string name;
+        std::vector<TraceEvent> events;
+    };
+
+    std::atomic_bool s_enabled = false;
+    std::chrono::steady_clock::time_point s_start;
+
+    std::mutex s_buffersMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> s_buffers;
+
+    thread_local size_t t_modSpanDepth = 0;
+
+    ThreadBuffer& localBuffer() {
+        thread_local auto buffer = [] {
+            auto buffer = std::make_shared<ThreadBuffer>();
+            std::lock_guard lock(s_buffersMutex);
+            buffer->id = static_cast<uint32_t>(s_buffers.size() + 1);
+            buffer->name = utils::thread::getName().view();
+            s_buffers.push_back(buffer);
+            return buffer;
+        }();
+        return *buffer;
+    }
+
+    int64_t microsSinceStart(std::chrono::steady_clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(time - s_start).count();
+    }
+
+    void record(TraceEvent event) {
+        // a span may have been open while tracing got disabled
+        if (!s_enabled.load(std::memory_order_acquire)) return;
+        auto& buffer = localBuffer();
+        std::lock_guard lock(buffer.mutex);
+        // threads are often named after they've started doing work
+        auto name = utils::thread::getName().view();
+        if (buffer.name != name) {
+            buffer.name = name;
+        }
+        buffer.events.push_back(std::move(event));
+    }
+
+    // copies everything out so the buffers aren't held while formatting
+    std::vector<std::pair<std::string, std::vector<TraceEvent>>> snapshot(std::vector<uint32_t>* ids = nullptr) {
+        std::vector<std::pair<std::string, std::vector<TraceEvent>>> ret;
+        std::lock_guard lock(s_buffersMutex);
+        for (auto& buffer : s_buffers) {
+            std::lock_guard bufferLock(buffer->mutex);
+            ret.emplace_back(buffer->name, buffer->events);
+            if (ids) ids->push_back(buffer->id);
+        }
+        return ret;
+    }
+}
+
+bool trace::isEnabled() {
+    return s_enabled.load(std::memory_order_acquire);
+}
+
+void trace::enable() {
+    if (s_enabled) return;
+    s_start = std::chrono::steady_clock::now();
+    s_enabled = true;
+}
+
+void trace::disable() {
+    if (!s_enabled.exchange(false)) return;
+    std::lock_guard lock(s_buffersMutex);
+    for (auto& buffer : s_buffers) {
+        std::lock_guard bufferLock(buffer->mutex);
+        std::vector<TraceEvent>().swap(buffer->events);
+    }
+}
+
+trace::Span::Span(std::string_view name, Mod* mod) {
+    if (!isEnabled()) return;
+    m_active = true;
+    m_name = name;
+    m_mod = mod;
+    if (m_mod) {
+        t_modSpanDepth += 1;
+    }
+    m_begin = std::chrono::steady_clock::now();
+}
+
+trace::Span::~Span() {
+    if (!m_active) return;
+    auto end = std::chrono::steady_clock::now();
+    if (m_mod) {
+        t_modSpanDepth -= 1;
+    }
+    record(TraceEvent {
+        .name = std::move(m_name),
+        .mod = m_mod ? std::string(m_mod->getID().view()) : std::string(),
+        .begin = microsSinceStart(m_begin),
+        .value = std::chrono::duration_cast<std::chrono::microseconds>(end - m_begin).count(),
+        .isCounter = false,
+        .isModRoot = m_mod && t_modSpanDepth == 0,
+    });
+}
+
+void trace::counter(std::string_view name, int64_t value) {
+    if (!isEnabled()) return;
+    record(TraceEvent {
+        .name = std::string(name),
+        .begin = microsSinceStart(std::chrono::steady_clock::now()),
+        .value = value,
+        .isCounter = true,
+        .isModRoot = false,
+    });
+}
+
+Result<> trace::exportChromeTrace(std::filesystem::path const& path) {
+    std::vector<uint32_t> ids;
+    auto threads = snapshot(&ids);
+
+    auto events = matjson::Value::array();
+    for (size_t i = 0; i < threads.size(); i++) {
+        auto& [name, threadEvents] = threads[i];
+        events.push(matjson::makeObject({
+            { "name", "thread_name" },
+            { "ph", "M" },
+            { "pid", 1 },
+            { "tid", ids[i] },
+            { "args", matjson::makeObject({ { "name", name } }) },
+        }));
+        for (auto& event : threadEvents) {
+            if (event.isCounter) {
+                events.push(matjson::makeObject({
+                    { "name", event.name },
+                    { "ph", "C" },
+                    { "ts", event.begin },
+                    { "pid", 1 },
+                    { "tid", ids[i] },
+                    { "args", matjson::makeObject({ { "value", event.value } }) },
+                }));
+                continue;
+            }
+            auto json = matjson::makeObject({
+                { "name", event.name },
+                { "cat", event.mod.empty() ? "loader" : "mod" },
+                { "ph", "X" },
+                { "ts", event.begin },
+                { "dur", event.value },
+                { "pid", 1 },
+                { "tid", ids[i] },
+            });
+            if (!event.mod.empty()) {
+                json["args"] = matjson::makeObject({ { "mod", event.mod } });
+            }
+            events.push(std::move(json));
+        }
+    }
+
+    return file::writeStringSafe(path, matjson::makeObject({
+        { "traceEvents", std::move(events) },
+        { "displayTimeUnit", "ms" },
+    }).dump(matjson::NO_INDENTATION));
+}
+
+std::string trace::summary() {
+    struct Total {
+        int64_t micros = 0;
+        size_t count = 0;
+    };
+    std::unordered_map<std::string, Total> phases;
+    std::unordered_map<std::string, Total> mods;
+    std::unordered_map<std::string, int64_t> counters;
+
+    for (auto& [_, events] : snapshot()) {
+        for (auto& event : events) {
+            if (event.isCounter) {
+                counters[event.name] = event.value;
+                continue;
+            }
+            auto& phase = phases[event.name];
+            phase.micros += event.value;
+            phase.count += 1;
+            if (event.isModRoot) {
+                auto& mod = mods[event.mod];
+                mod.micros += event.value;
+                mod.count += 1;
+            }
+        }
+    }
+
+    auto sorted = [](std::unordered_map<std::string, Total> const& map) {
+        std::vector<std::pair<std::string, Total>> ret(map.begin(), map.end());
+        std::sort(ret.begin(), ret.end(), [](auto const& a, auto const& b) {
+            return a.second.micros > b.second.micros;
+        });
+        return ret;
+    };
+
+    std::string ret = "Phases (inclusive time):\n";
+    for (auto& [name, total] : sorted(phases)) {
+        ret += fmt::format("  {:<32} {:>10.2f}ms  x{}\n", name, total.micros / 1000.0, total.count);
+    }
+    ret += "Mods:\n";
+    for (auto& [id, total] : sorted(mods)) {
+        ret += fmt::format("  {:<32} {:>10.2f}ms\n", id, total.micros / 1000.0);
+    }
+    if (!counters.empty()) {
+        ret += "Counters:\n";
+        for (auto& [name, value] : counters) {
+            ret += fmt::format("  {:<32} {:>10}\n", name, value);
+        }
+    }
+    return ret;
+}
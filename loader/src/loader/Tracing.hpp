@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Geode/Result.hpp>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace geode {
+    class Mod;
+}
+
+namespace geode::trace {
+    /// Tracing is off unless started with the trace-startup launch flag, in which case
+    /// every span and counter is recorded until the trace gets exported
+    bool isEnabled();
+    void enable();
+    /// Stops recording and frees everything recorded so far
+    void disable();
+
+    /// Records how long the enclosing scope took, optionally attributed to a mod.
+    /// Spans nest per thread, so they show up as a call tree in the trace viewer
+    class Span final {
+    public:
+        Span(std::string_view name, Mod* mod = nullptr);
+        ~Span();
+
+        Span(Span const&) = delete;
+        Span& operator=(Span const&) = delete;
+
+    private:
+        bool m_active = false;
+        std::string m_name;
+        Mod* m_mod = nullptr;
+        std::chrono::steady_clock::time_point m_begin;
+    };
+
+    void counter(std::string_view name, int64_t value);
+
+    /// Writes everything recorded so far in the Chrome trace event format, which can be
+    /// opened in chrome://tracing or ui.perfetto.dev
+    Result<> exportChromeTrace(std::filesystem::path const& path);
+    /// Plain text breakdown of where the time went, per phase and per mod
+    std::string summary();
+}
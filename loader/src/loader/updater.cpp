@@ -1,5 +1,6 @@
 #include "updater.hpp"
 #include <asp/fs/fs.hpp>
+#include <asp/time/SystemTime.hpp>
 #include <Geode/utils/web.hpp>
 #include <resources.hpp>
 #include <hash.hpp>
@@ -9,10 +10,19 @@
 #include <Geode/utils/string.hpp>
 #include <Geode/utils/StringMap.hpp>
 
+#ifndef GEODE_IS_WINDOWS
+# include <sys/stat.h>
+#endif
+
 #include "../server/Server.hpp"
 
 using namespace geode::prelude;
 
+// every resource gets hashed again in the background at most this often,
+// otherwise only files whose size, modification time or inode changed are
+static constexpr auto RESOURCE_FULL_VERIFY_INTERVAL = std::chrono::hours(24 * 7);
+static constexpr int RESOURCE_VERIFY_CACHE_VERSION = 1;
+
 static StringMap<async::TaskHolder<web::WebResponse>> RUNNING_REQUESTS {};
 
 bool s_isNewUpdateDownloaded = false;
@@ -173,6 +183,124 @@ void updater::downloadLoaderResources(bool useLatestRelease) {
 
 }
 
+namespace {
+    struct ResourceStat {
+        uint64_t size = 0;
+        int64_t modifiedTime = 0;
+        // always 0 on windows, where getting the file index means opening the file
+        uint64_t inode = 0;
+
+        bool operator==(ResourceStat const&) const = default;
+    };
+
+    struct VerifiedResource {
+        ResourceStat stat;
+        std::string hash;
+    };
+
+    struct ResourceVerifyCache {
+        int64_t fullyVerifiedAt = 0;
+        std::unordered_map<std::string, VerifiedResource> files;
+    };
+
+    std::filesystem::path resourceVerifyCachePath() {
+        return dirs::getModRuntimeDir() / "resource-verification.json";
+    }
+
+    std::optional<ResourceStat> statResource(std::filesystem::path const& path) {
+        std::error_code ec;
+        ResourceStat ret;
+        ret.size = std::filesystem::file_size(path, ec);
+        if (ec) return std::nullopt;
+        ret.modifiedTime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+        if (ec) return std::nullopt;
+#ifndef GEODE_IS_WINDOWS
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0) {
+            ret.inode = static_cast<uint64_t>(st.st_ino);
+        }
+#endif
+        return ret;
+    }
+
+    ResourceVerifyCache readResourceVerifyCache() {
+        ResourceVerifyCache cache;
+        auto res = file::readJson(resourceVerifyCachePath());
+        if (!res) {
+            return cache;
+        }
+        auto json = std::move(res).unwrap();
+        if (json["version"].asInt().unwrapOr(0) != RESOURCE_VERIFY_CACHE_VERSION) {
+            return cache;
+        }
+        cache.fullyVerifiedAt = json["fully-verified-at"].asInt().unwrapOr(0);
+        for (auto& [name, value] : json["files"]) {
+            cache.files.insert({ name, VerifiedResource {
+                .stat = ResourceStat {
+                    .size = value["size"].asUInt().unwrapOr(0),
+                    .modifiedTime = value["modified"].asInt().unwrapOr(0),
+                    .inode = value["inode"].asUInt().unwrapOr(0),
+                },
+                .hash = value["hash"].asString().unwrapOr(""),
+            } });
+        }
+        return cache;
+    }
+
+    void writeResourceVerifyCache(ResourceVerifyCache const& cache) {
+        auto files = matjson::Value::object();
+        for (auto& [name, file] : cache.files) {
+            files[name] = matjson::makeObject({
+                { "size", file.stat.size },
+                { "modified", file.stat.modifiedTime },
+                { "inode", file.stat.inode },
+                { "hash", file.hash },
+            });
+        }
+        auto res = file::writeStringSafe(resourceVerifyCachePath(), matjson::makeObject({
+            { "version", RESOURCE_VERIFY_CACHE_VERSION },
+            { "fully-verified-at", cache.fullyVerifiedAt },
+            { "files", files },
+        }).dump(matjson::NO_INDENTATION));
+        if (!res) {
+            log::warn("Failed to save resource verification cache: {}", res.unwrapErr());
+        }
+    }
+
+    int64_t nowSeconds() {
+        return asp::SystemTime::now().timeSinceEpoch().seconds();
+    }
+
+    // hashes every resource, regardless of what the cache says
+    void fullyVerifyLoaderResources(std::filesystem::path resourcesDir) {
+        ResourceVerifyCache cache;
+        for (auto& [name, expected] : LOADER_RESOURCE_HASHES) {
+            auto path = resourcesDir / name;
+            auto stat = statResource(path);
+            if (!stat) {
+                log::debug("Background verification: resource {} is missing", name);
+                Loader::get()->queueInMainThread([] {
+                    updater::downloadLoaderResources();
+                });
+                return;
+            }
+            // if we hash anything other than text, change this
+            auto hash = calculateSHA256Text(path);
+            if (hash != expected) {
+                log::debug("Background verification: resource hash mismatch: {} ({}, {})", name, hash.substr(0, 7), expected.substr(0, 7));
+                Loader::get()->queueInMainThread([] {
+                    updater::downloadLoaderResources();
+                });
+                return;
+            }
+            cache.files.insert({ name, VerifiedResource { *stat, std::move(hash) } });
+        }
+        cache.fullyVerifiedAt = nowSeconds();
+        writeResourceVerifyCache(cache);
+        log::debug("Background verification of loader resources finished");
+    }
+}
+
 bool updater::verifyLoaderResources() {
     static std::optional<bool> CACHED = std::nullopt;
     if (CACHED.has_value()) {
@@ -204,22 +332,42 @@ bool updater::verifyLoaderResources() {
     // make sure every file was covered
     size_t coverage = 0;
 
+    // files that haven't changed on disk since they were last verified are
+    // trusted without hashing them again
+    auto cache = readResourceVerifyCache();
+    ResourceVerifyCache newCache;
+    size_t hashed = 0;
+
     // verify hashes
     for (auto& file : std::filesystem::directory_iterator(resourcesDir)) {
         auto name = utils::string::pathToString(file.path().filename());
         // skip unknown files
-        if (!LOADER_RESOURCE_HASHES.count(name)) {
+        auto expectedIt = LOADER_RESOURCE_HASHES.find(name);
+        if (expectedIt == LOADER_RESOURCE_HASHES.end()) {
+            continue;
+        }
+        const auto& expected = expectedIt->second;
+
+        auto stat = statResource(file.path());
+        auto cached = cache.files.find(name);
+        if (stat && cached != cache.files.end() && cached->second.stat == *stat && cached->second.hash == expected) {
+            newCache.files.insert(*cached);
+            coverage += 1;
             continue;
         }
+
         // verify hash
         // if we hash anything other than text, change this
         auto hash = calculateSHA256Text(file.path());
-        const auto& expected = LOADER_RESOURCE_HASHES.at(name);
+        hashed += 1;
         if (hash != expected) {
             log::debug("Resource hash mismatch: {} ({}, {})", name, hash.substr(0, 7), expected.substr(0, 7));
             updater::downloadLoaderResources();
             return false;
         }
+        if (stat) {
+            newCache.files.insert({ name, VerifiedResource { *stat, std::move(hash) } });
+        }
         coverage += 1;
     }
 
@@ -230,6 +378,22 @@ bool updater::verifyLoaderResources() {
         return false;
     }
 
+    log::debug("Verified loader resources, {} of {} needed hashing", hashed, coverage);
+
+    // if everything got hashed just now, that counts as a full verification
+    newCache.fullyVerifiedAt = hashed == coverage ? nowSeconds() : cache.fullyVerifiedAt;
+    if (hashed > 0 || newCache.files.size() != cache.files.size()) {
+        writeResourceVerifyCache(newCache);
+    }
+
+    auto sinceFullVerify = std::chrono::seconds(nowSeconds() - newCache.fullyVerifiedAt);
+    if (sinceFullVerify >= RESOURCE_FULL_VERIFY_INTERVAL) {
+        log::debug("Verifying all loader resources in the background");
+        async::runtime().spawnBlocking<void>([resourcesDir] {
+            fullyVerifyLoaderResources(resourcesDir);
+        });
+    }
+
     return true;
 }
 
@@ -258,7 +422,7 @@ void updater::downloadLoaderUpdate(std::string url) {
             if (response.ok()) {
                 // unzip resources zip
                 auto data = std::move(response).data();
-                auto unzip = file::Unzip::create(data);
+                auto unzip = file::Unzip::create(std::move(data));
                 if (unzip) {
                     auto ok = unzip.unwrap().extractAllTo(targetDir);
                     if (ok) {
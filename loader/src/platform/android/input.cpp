@@ -1,6 +1,7 @@
 #include <Geode/utils/AndroidEvent.hpp>
 #include <Geode/utils/Keyboard.hpp>
 #include <Geode/Prelude.hpp>
+#include <Geode/loader/Loader.hpp>
 #include <cocos2d.h>
 #include <android/keycodes.h>
 #include <android/input.h>
@@ -504,17 +505,24 @@ std::vector<AndroidJoystickInput::Data> const& AndroidJoystickInput::packets() c
 
 extern "C"
 JNIEXPORT void JNICALL Java_com_geode_launcher_utils_GeodeUtils_inputDeviceAdded(JNIEnv*, jobject, jint deviceId, jint eventSource) {
-    geode::AndroidInputDeviceEvent().send(deviceId, geode::AndroidInputDeviceStatus::Added);
+    // device changes are reported on the Android UI thread, listeners are on the GL thread
+    geode::Loader::get()->queueInMainThread([deviceId] {
+        geode::AndroidInputDeviceEvent().send(deviceId, geode::AndroidInputDeviceStatus::Added);
+    });
 }
 
 extern "C"
 JNIEXPORT void JNICALL Java_com_geode_launcher_utils_GeodeUtils_inputDeviceChanged(JNIEnv*, jobject, jint deviceId, jint eventSource) {
-    geode::AndroidInputDeviceEvent().send(deviceId, geode::AndroidInputDeviceStatus::Changed);
+    geode::Loader::get()->queueInMainThread([deviceId] {
+        geode::AndroidInputDeviceEvent().send(deviceId, geode::AndroidInputDeviceStatus::Changed);
+    });
 }
 
 extern "C"
 JNIEXPORT void JNICALL Java_com_geode_launcher_utils_GeodeUtils_inputDeviceRemoved(JNIEnv*, jobject, jint deviceId, jint eventSource) {
-    geode::AndroidInputDeviceEvent().send(deviceId, geode::AndroidInputDeviceStatus::Removed);
+    geode::Loader::get()->queueInMainThread([deviceId] {
+        geode::AndroidInputDeviceEvent().send(deviceId, geode::AndroidInputDeviceStatus::Removed);
+    });
 }
 
 extern "C"
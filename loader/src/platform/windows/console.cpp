@@ -83,7 +83,10 @@ bool redirectStd(FILE* which, ZStringView name, const Severity sev) {
                 if (c == '\r') continue;
                 if (c == '\n') {
                     // complete line
-                    log::Logger::get()->push(sev, 0, line, "", name, nullptr);
+                    auto logger = log::Logger::get();
+                    if (logger->shouldOutputLog(sev, nullptr)) {
+                        logger->push(sev, 0, line, "", name, nullptr);
+                    }
                     line.clear();
                     continue;
                 }
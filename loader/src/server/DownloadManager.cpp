@@ -1,8 +1,12 @@
 #include "DownloadManager.hpp"
 #include <Geode/loader/Mod.hpp>
 #include <Geode/loader/Dirs.hpp>
+#include <Geode/utils/file.hpp>
 #include <Geode/utils/map.hpp>
 #include <Geode/utils/StringMap.hpp>
+#include <Geode/utils/string.hpp>
+#include <Geode/utils/async.hpp>
+#include <array>
 #include <fmt/format.h>
 #include <optional>
 #include <hash/hash.hpp>
@@ -11,6 +15,98 @@
 
 using namespace server;
 
+// how long an interrupted download is kept around for resuming
+static constexpr auto PARTIAL_DOWNLOAD_MAX_AGE = std::chrono::days{3};
+
+// downloaded next to its final location (with an extension the loader
+// ignores), so it can be moved into place without copying, and so a
+// download that gets interrupted can pick up from there next time
+static std::filesystem::path partPathFor(std::string_view id) {
+    return dirs::getModsDir() / fmt::format("{}.geode.part", id);
+}
+
+// removes a partial download along with the state FileDownload keeps next to it
+static void removePartialDownload(std::filesystem::path const& partPath) {
+    auto statePath = partPath;
+    statePath += ".state";
+    std::error_code ec;
+    std::filesystem::remove(partPath, ec);
+    std::filesystem::remove(statePath, ec);
+}
+
+// Looks at a .geode package as it gets written to disk. Data that arrives in
+// order (which is all of it when the server doesn't support ranges) is hashed
+// on the way, so the finished package doesn't have to be read back
+class PackageSink final {
+public:
+    // called on the networking thread, never concurrently
+    Result<> write(uint64_t offset, ByteSpan data) {
+        // every zip starts with a local file header, so anything else (like
+        // an error page from a proxy) can be rejected before downloading the rest
+        for (size_t i = 0; offset + i < ZIP_MAGIC.size() && i < data.size(); i++) {
+            if (data[i] != ZIP_MAGIC[offset + i]) {
+                return Err("Downloaded file is not a .geode package");
+            }
+        }
+
+        // a retry without ranges starts over from the beginning
+        if (offset == 0) {
+            m_hash.emplace();
+            m_hashed = 0;
+        }
+        if (m_hash && offset == m_hashed) {
+            m_hash->update(data);
+            m_hashed += data.size();
+        }
+        else {
+            m_hash.reset();
+        }
+        return Ok();
+    }
+
+    // returns the hash of the finished package
+    Result<std::string> finish(std::filesystem::path const& path) {
+        std::error_code ec;
+        auto size = std::filesystem::file_size(path, ec);
+        if (ec || size < ZIP_MAGIC.size()) {
+            return Err("Downloaded file is not a .geode package");
+        }
+
+        auto hash = m_hash && m_hashed == size ? m_hash->finish() : "";
+        // downloaded in parts or resumed from an earlier attempt
+        if (hash.empty()) {
+            hash = calculateSHA256(path);
+        }
+        if (hash.empty()) {
+            return Err("Unable to hash downloaded file");
+        }
+        return Ok(std::move(hash));
+    }
+
+private:
+    static constexpr std::array<uint8_t, 4> ZIP_MAGIC = { 'P', 'K', 0x03, 0x04 };
+
+    std::optional<IncrementalHash> m_hash;
+    uint64_t m_hashed = 0;
+};
+
+// Downloads a .geode package to the given path and returns its hash. Parts
+// that were already downloaded by an earlier, interrupted attempt are kept
+static arc::Future<Result<std::string>> downloadPackage(
+    web::FileDownload download, std::string url, std::filesystem::path path
+) {
+    auto sink = std::make_shared<PackageSink>();
+    download.onData([sink](uint64_t offset, ByteSpan data) {
+        return sink->write(offset, data);
+    });
+
+    auto res = co_await download.download(std::move(url), path);
+    if (!res) {
+        co_return Err(std::move(res).unwrapErr());
+    }
+    co_return sink->finish(path);
+}
+
 class ModDownload::Impl final {
 public:
     std::string m_id;
@@ -18,7 +114,7 @@ public:
     std::optional<DependencyFor> m_dependencyFor;
     std::optional<std::string> m_replacesMod;
     DownloadStatus m_status;
-    async::TaskHolder<web::WebResponse> m_downloadListener;
+    async::TaskHolder<Result<std::string>> m_downloadListener;
     async::TaskHolder<ServerResult<ServerModVersion>> m_infoListener;
     unsigned int m_scheduledEventForFrame = 0;
 
@@ -75,37 +171,22 @@ public:
         });
     }
 
-    void onFinished(web::WebResponse response, ServerModVersion version) {
-        if (!response.ok()) {
-            if (response.code() == -1) {
-                m_status = DownloadStatusError {
-                    .details = fmt::format(
-                        "Failed to make request to download endpoint. Error: {}",
-                        response.string().unwrapOr("No message")
-                    )
-                };
-            } else {
-                m_status = DownloadStatusError {
-                    .details = fmt::format(
-                        "Server returned error {} with message: {}",
-                        response.code(),
-                        response.string().unwrapOr("No message")
-                    )
-                };
-            }
-
-            log::error("Failed to download {}, server returned error {}", m_id, response.code());
-            log::error("{}", response.string().unwrapOr("No response"));
+    void onFinished(Result<std::string> hashRes, ServerModVersion version, std::filesystem::path partPath) {
+        auto discard = [&] {
+            std::error_code ec;
+            std::filesystem::remove(partPath, ec);
+        };
 
-            const auto& extErr = response.errorMessage();
-            if (!extErr.empty()) {
-                log::error("Extended error info: {}", extErr);
-            }
+        if (!hashRes) {
+            log::error("Failed to download {}: {}", m_id, hashRes.unwrapErr());
+            m_status = DownloadStatusError {
+                .details = std::move(hashRes).unwrapErr(),
+            };
             return;
         }
-
-        auto actualHash = ::calculateHash(response.data());
+        auto actualHash = std::move(hashRes).unwrap();
         if (actualHash != version.hash) {
+            discard();
             log::error("Failed to download {}, hash mismatch ({} != {})", m_id, actualHash, version.hash);
             m_status = DownloadStatusError {
                 .details = "Hash mismatch, downloaded file did not match what was expected",
@@ -113,11 +194,22 @@ public:
             return;
         }
 
+        // make sure the central directory can be read before replacing anything
+        if (auto unzip = file::Unzip::create(partPath); !unzip) {
+            discard();
+            log::error("Failed to download {}, package is not a valid zip: {}", m_id, unzip.unwrapErr());
+            m_status = DownloadStatusError {
+                .details = "Downloaded file is not a valid .geode package",
+            };
+            return;
+        }
+
         std::string id = m_replacesMod.has_value() ? m_replacesMod.value() : m_id;
         if (auto mod = Loader::get()->getInstalledMod(id)) {
             std::error_code ec;
             std::filesystem::remove(mod->getPackagePath(), ec);
             if (ec) {
+                discard();
                 m_status = DownloadStatusError {
                     .details = fmt::format("Unable to delete existing .geode package (code {})", ec),
                 };
@@ -129,11 +221,12 @@ public:
 
         // If this was an update, delete the old file first
         auto geodePath = dirs::getModsDir() / (m_id + ".geode");
-        auto data = std::move(response).data();
-        auto ok = file::writeBinary(geodePath, data);
-        if (!ok) {
+        std::error_code ec;
+        std::filesystem::rename(partPath, geodePath, ec);
+        if (ec) {
+            discard();
             m_status = DownloadStatusError {
-                .details = std::move(ok).unwrapErr(),
+                .details = fmt::format("Unable to move downloaded package into place (code {})", ec),
             };
             return;
         }
@@ -165,8 +258,10 @@ public:
             .percentage = 0,
         };
 
-        auto req = web::WebRequest().userAgent(getServerUserAgent());
-        req.onProgress([this, id = std::string(m_id)](const auto& progress) {
+        auto partPath = partPathFor(m_id);
+
+        auto download = web::FileDownload().userAgent(getServerUserAgent());
+        download.onProgress([this, id = std::string(m_id)](const auto& progress) {
             m_status = DownloadStatusDownloading {
                 .percentage = static_cast<uint8_t>(progress.downloadProgress().value_or(0)),
             };
@@ -174,9 +269,9 @@ public:
         });
 
         m_downloadListener.spawn(
-            req.get(std::move(downloadURL)),
-            [this, version = std::move(version)](web::WebResponse response) mutable {
-                this->onFinished(std::move(response), std::move(version));
+            downloadPackage(std::move(download), std::move(downloadURL), partPath),
+            [this, version = std::move(version), partPath](Result<std::string> result) mutable {
+                this->onFinished(std::move(result), std::move(version), std::move(partPath));
 
                 // post event
                 if (m_scheduledEventForFrame != CCDirector::get()->getTotalFrames()) {
@@ -278,10 +373,19 @@ public:
 
 void ModDownload::cancel() {
     if (!std::holds_alternative<DownloadStatusDone>(m_impl->m_status)) {
+        auto wasDownloading = std::holds_alternative<DownloadStatusDownloading>(m_impl->m_status);
         m_impl->m_status = DownloadStatusCancelled();
         m_impl->m_infoListener = {};
         m_impl->m_downloadListener = {};
 
+        // a cancelled download isn't going to be resumed, so don't leave it
+        // taking up space in the mods folder
+        if (wasDownloading) {
+            async::runtime().spawnBlocking<void>([partPath = partPathFor(m_impl->m_id)] {
+                removePartialDownload(partPath);
+            });
+        }
+
         // Cancel any dependencies of this mod left over (unless some other
         // installation depends on them still)
         ModDownloadManager::get()->m_impl->cancelOrphanedDependencies();
@@ -439,6 +543,31 @@ std::optional<RecentlyUpdatedMod> ModDownloadManager::getRecentlyUpdatedInfo(std
     return it != m_impl->recentlyUpdated.end() ? std::optional(*it) : std::nullopt;
 }
 
+// downloads that were interrupted and never retried would otherwise stay
+// in the mods folder forever
+static void prunePartialDownloads() {
+    std::error_code ec;
+    auto now = std::filesystem::file_time_type::clock::now();
+    for (auto& entry : std::filesystem::directory_iterator(dirs::getModsDir(), ec)) {
+        // the state file may outlive its download, so the two are checked separately
+        auto name = utils::string::pathToString(entry.path().filename());
+        if (!name.ends_with(".geode.part") && !name.ends_with(".geode.part.state")) continue;
+
+        auto modified = entry.last_write_time(ec);
+        if (ec || now - modified < PARTIAL_DOWNLOAD_MAX_AGE) continue;
+
+        log::debug("Removing stale partial download {}", name);
+        std::filesystem::remove(entry.path(), ec);
+    }
+}
+
+$on_mod(Loaded) {
+    // put it in a task so that it doesn't slow down launch times
+    async::runtime().spawnBlocking<void>([] {
+        prunePartialDownloads();
+    });
+}
+
 ModDownloadManager* ModDownloadManager::get() {
     static auto inst = new ModDownloadManager();
     return inst;
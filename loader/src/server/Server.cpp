@@ -1,11 +1,20 @@
 #include "Server.hpp"
+#include <Geode/loader/Dirs.hpp>
 #include <Geode/utils/JsonValidation.hpp>
+#include <Geode/utils/async.hpp>
+#include <Geode/utils/file.hpp>
 #include <Geode/utils/ranges.hpp>
 #include <chrono>
+#include <hash/hash.hpp>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <fmt/format.h>
 #include <loader/ModMetadataImpl.hpp>
 #include <fmt/chrono.h>
 #include <arc/sync/Mutex.hpp>
+#include <arc/sync/oneshot.hpp>
 #include <loader/LoaderImpl.hpp>
 #include "../internal/about.hpp"
 #include "Geode/loader/Loader.hpp"
@@ -14,81 +23,316 @@ using namespace server;
 
 #define GEODE_GD_VERSION_STR GEODE_STR(GEODE_GD_VERSION)
 
-template <class K, class V>
-    requires std::equality_comparable<K> && std::copy_constructible<K>
-class CacheMap final {
+template <class V>
+class LruCache final {
+public:
+    using Clock = std::chrono::system_clock;
+
+    struct Lookup {
+        V value;
+        bool stale;
+    };
+
 private:
-    // I know this looks like a goofy choice over just
-    // `std::unordered_map`, but hear me out:
-    //
-    // This needs preserved insertion order (so shrinking the cache
-    // to match size limits doesn't just have to erase random
-    // elements)
-    //
-    // If this used a map for values and another vector for storing
-    // insertion order, it would have a pretty big memory footprint
-    // (two copies of Query, one for order, one for map + two heap
-    // allocations on top of that)
-    //
-    // In addition, it would be a bad idea to have a cache of 1000s
-    // of items in any case (since that would likely take up a ton
-    // of memory, which we want to avoid since it's likely many
-    // crashes with the old index were due to too much memory
-    // usage)
-    //
-    // Linear searching a vector of at most a couple dozen items is
-    // lightning-fast (🚀), and besides the main performance benefit
-    // comes from the lack of a web request - not how many extra
-    // milliseconds we can squeeze out of a map access
-    std::vector<std::pair<K, V>> m_values;
+    struct Entry {
+        std::string key;
+        V value;
+        Clock::time_point storedAt;
+    };
+
+    // Most recently used entries are at the front, so going back to a
+    // previous page doesn't get it evicted by everything browsed since
+    std::list<Entry> m_entries;
+    std::unordered_map<std::string, typename std::list<Entry>::iterator> m_index;
     size_t m_sizeLimit = 20;
+    std::chrono::seconds m_maxAge = std::chrono::seconds::max();
 
-public:
-    std::optional<V> get(K const& key) {
-        auto it = std::find_if(m_values.begin(), m_values.end(), [&key](auto const& q) {
-            return q.first == key;
-        });
-        if (it != m_values.end()) {
-            return it->second;
+    void trim() {
+        while (m_entries.size() > m_sizeLimit) {
+            m_index.erase(m_entries.back().key);
+            m_entries.pop_back();
         }
-        return std::nullopt;
-    }
-    bool has(K const& key) {
-        return std::find_if(m_values.begin(), m_values.end(), [&key](auto const& q) {
-            return q.first == key;
-        }) != m_values.end();
     }
-    void add(K&& key, V&& value) {
-        auto pair = std::make_pair(std::move(key), std::move(value));
 
-        // Shift and replace last element if we're at cache size limit
-        if (m_values.size() >= m_sizeLimit) {
-            std::shift_left(m_values.begin(), m_values.end(), 1);
-            m_values.back() = std::move(pair);
+public:
+    std::optional<Lookup> get(std::string const& key) {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) {
+            return std::nullopt;
         }
-        // Otherwise append at end
-        else {
-            m_values.emplace_back(std::move(pair));
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        auto& entry = *it->second;
+        auto age = std::chrono::duration_cast<std::chrono::seconds>(Clock::now() - entry.storedAt);
+        return Lookup {
+            .value = entry.value,
+            .stale = age > m_maxAge,
+        };
+    }
+    void add(std::string key, V value, Clock::time_point storedAt = Clock::now()) {
+        if (auto it = m_index.find(key); it != m_index.end()) {
+            it->second->value = std::move(value);
+            it->second->storedAt = storedAt;
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return;
         }
+        m_entries.push_front(Entry {
+            .key = key,
+            .value = std::move(value),
+            .storedAt = storedAt,
+        });
+        m_index.emplace(std::move(key), m_entries.begin());
+        this->trim();
     }
-    void remove(K const& key) {
-        ranges::remove(m_values, [&key](auto const& q) { return q.first == key; });
+    void remove(std::string const& key) {
+        if (auto it = m_index.find(key); it != m_index.end()) {
+            m_entries.erase(it->second);
+            m_index.erase(it);
+        }
     }
     void clear() {
-        m_values.clear();
+        m_entries.clear();
+        m_index.clear();
     }
     void limit(size_t size) {
         m_sizeLimit = size;
-        m_values.clear();
+        this->trim();
+    }
+    void maxAge(std::chrono::seconds age) {
+        m_maxAge = age;
     }
     size_t size() const {
-        return m_values.size();
+        return m_entries.size();
     }
     size_t limit() const {
         return m_sizeLimit;
     }
 };
 
+static matjson::Value cacheKeyPart(std::string const& str) {
+    return str;
+}
+static matjson::Value cacheKeyPart(ModVersion const& version) {
+    return std::visit(makeVisitor {
+        [](ModVersionLatest const&) {
+            return std::string("latest");
+        },
+        [](ModVersionMajor const& ver) {
+            return fmt::format("major:{}", ver.major);
+        },
+        [](ModVersionSpecific const& ver) {
+            return ver.toVString();
+        },
+    }, version);
+}
+static matjson::Value cacheKeyPart(ModsQuery const& query) {
+    // Sets have no stable order, so sort them for the key to match between sessions
+    std::vector<std::string> platforms;
+    for (auto plat : query.platforms) {
+        platforms.emplace_back(PlatformID::toShortString(plat.m_value));
+    }
+    std::sort(platforms.begin(), platforms.end());
+    std::vector<std::string> tags(query.tags.begin(), query.tags.end());
+    std::sort(tags.begin(), tags.end());
+
+    return matjson::makeObject({
+        { "query", query.query ? matjson::Value(*query.query) : matjson::Value() },
+        { "platforms", ranges::join(platforms, ",") },
+        { "tags", ranges::join(tags, ",") },
+        { "featured", query.featured ? matjson::Value(*query.featured) : matjson::Value() },
+        { "sort", sortToString(query.sorting) },
+        { "developer", query.developer ? matjson::Value(*query.developer) : matjson::Value() },
+        { "page", query.page },
+        { "per_page", query.pageSize },
+    });
+}
+
+template <class... Args>
+static std::string makeCacheKey(Args const&... args) {
+    auto key = matjson::Value::array();
+    (key.push(cacheKeyPart(args)), ...);
+    return key.dump(matjson::NO_INDENTATION);
+}
+
+static constexpr auto SERVER_CACHE_MAX_STALE = std::chrono::days(7);
+static constexpr size_t SERVER_CACHE_MAX_FILES = 256;
+
+// Responses of the persistent caches are kept on disk, one file per entry, so
+// that a cold start can show the last known results while fresh ones load
+class ServerCacheStore final {
+private:
+    std::filesystem::path m_dir = dirs::getCacheDir() / "server";
+    std::once_flag m_pruned;
+
+    std::filesystem::path pathFor(std::string_view name, std::string const& key) const {
+        return m_dir / fmt::format("{}-{}.json", name, calculateHash(key));
+    }
+
+    // Drops entries too old to be worth serving, and the least recently
+    // written ones if there are still too many left over
+    void prune() {
+        std::error_code ec;
+        std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> files;
+        auto now = std::filesystem::file_time_type::clock::now();
+        for (auto& file : std::filesystem::directory_iterator(m_dir, ec)) {
+            if (file.path().extension() != ".json") continue;
+            auto time = file.last_write_time(ec);
+            if (ec || now - time > SERVER_CACHE_MAX_STALE) {
+                std::filesystem::remove(file.path(), ec);
+                continue;
+            }
+            files.emplace_back(time, file.path());
+        }
+        if (files.size() <= SERVER_CACHE_MAX_FILES) {
+            return;
+        }
+        std::sort(files.begin(), files.end(), [](auto const& a, auto const& b) {
+            return a.first > b.first;
+        });
+        for (size_t i = SERVER_CACHE_MAX_FILES; i < files.size(); i++) {
+            std::filesystem::remove(files[i].second, ec);
+        }
+    }
+
+public:
+    struct Stored {
+        matjson::Value payload;
+        std::chrono::system_clock::time_point storedAt;
+    };
+
+    static ServerCacheStore& get() {
+        static ServerCacheStore inst;
+        return inst;
+    }
+
+    std::optional<Stored> load(std::string_view name, std::string const& key) {
+        auto path = this->pathFor(name, key);
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec)) {
+            return std::nullopt;
+        }
+        auto json = file::readJson(path);
+        if (!json) {
+            std::filesystem::remove(path, ec);
+            return std::nullopt;
+        }
+        auto& root = json.unwrap();
+        auto storedAt = std::chrono::system_clock::time_point(
+            std::chrono::seconds(root["stored-at"].asInt().unwrapOr(0))
+        );
+        // Responses depend on the loader version (it's sent along with most queries),
+        // so anything cached by a different one can't be trusted
+        if (
+            root["key"].asString().unwrapOr("") != key ||
+            root["loader"].asString().unwrapOr("") != Loader::get()->getVersion().toNonVString() ||
+            std::chrono::system_clock::now() - storedAt > SERVER_CACHE_MAX_STALE
+        ) {
+            std::filesystem::remove(path, ec);
+            return std::nullopt;
+        }
+        return Stored {
+            .payload = std::move(root["payload"]),
+            .storedAt = storedAt,
+        };
+    }
+
+    void store(std::string_view name, std::string key, matjson::Value payload) {
+        auto path = this->pathFor(name, key);
+        async::runtime().spawnBlocking<void>([this, path = std::move(path), key = std::move(key), payload = std::move(payload)] {
+            std::error_code ec;
+            std::filesystem::create_directories(m_dir, ec);
+            std::call_once(m_pruned, [this] { this->prune(); });
+
+            auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()
+            );
+            auto res = file::writeStringSafe(path, matjson::makeObject({
+                { "key", key },
+                { "loader", Loader::get()->getVersion().toNonVString() },
+                { "stored-at", seconds.count() },
+                { "payload", payload },
+            }).dump(matjson::NO_INDENTATION));
+            if (!res) {
+                log::warn("Unable to save server cache entry: {}", res.unwrapErr());
+            }
+        });
+    }
+
+    void clear(std::string_view name) {
+        auto prefix = fmt::format("{}-", name);
+        std::error_code ec;
+        for (auto& file : std::filesystem::directory_iterator(m_dir, ec)) {
+            if (file.path().filename().string().starts_with(prefix)) {
+                std::filesystem::remove(file.path(), ec);
+            }
+        }
+    }
+};
+
+// How long responses of a function stay fresh, and whether they are kept on
+// disk. Persistent responses past their age are still returned right away
+// while a fresh copy is fetched in the background. Their requests skip the
+// HTTP cache, since that would be a second copy going stale on its own terms
+template <auto F>
+struct ServerCachePolicy {
+    static constexpr auto MaxAge = std::chrono::seconds::max();
+    static constexpr bool Persistent = false;
+};
+
+template <>
+struct ServerCachePolicy<&server::getMods> {
+    static constexpr std::chrono::seconds MaxAge = std::chrono::minutes(5);
+    static constexpr bool Persistent = true;
+    static constexpr std::string_view Name = "mods";
+
+    static Result<ServerModsList> parse(matjson::Value json) {
+        return ServerModsList::parse(std::move(json));
+    }
+};
+
+template <>
+struct ServerCachePolicy<&server::getMod> {
+    static constexpr std::chrono::seconds MaxAge = std::chrono::minutes(10);
+    static constexpr bool Persistent = true;
+    static constexpr std::string_view Name = "mod";
+
+    static Result<ServerModMetadata> parse(matjson::Value json) {
+        return ServerModMetadata::parse(std::move(json));
+    }
+};
+
+template <>
+struct ServerCachePolicy<&server::getTags> {
+    static constexpr std::chrono::seconds MaxAge = std::chrono::hours(1);
+    static constexpr bool Persistent = true;
+    static constexpr std::string_view Name = "tags";
+
+    static Result<std::vector<ServerTag>> parse(matjson::Value json) {
+        return ServerTag::parseList(std::move(json));
+    }
+};
+
+template <>
+struct ServerCachePolicy<&server::checkAllUpdates> {
+    static constexpr std::chrono::seconds MaxAge = std::chrono::minutes(10);
+    static constexpr bool Persistent = true;
+    static constexpr std::string_view Name = "updates";
+
+    static Result<ServerModUpdateAllCheck> parse(matjson::Value json) {
+        return ServerModUpdateAllCheck::parse(std::move(json));
+    }
+
+    // The result depends on which mods are installed, which is only
+    // known by the caller and can change between sessions
+    static std::string scope() {
+        auto mods = ranges::map<std::vector<std::string>>(
+            Loader::get()->getAllMods(),
+            [](auto mod) { return fmt::format("{}@{}", mod->getID(), mod->getVersion().toNonVString()); }
+        );
+        std::sort(mods.begin(), mods.end());
+        return ranges::join(mods, ",");
+    }
+};
+
 template <class F>
 struct ExtractFun;
 
@@ -113,86 +357,169 @@ public:
     using Extract  = ExtractFun<decltype(F)>;
     using CacheKey = typename Extract::CacheKey;
     using Value    = typename Extract::Value;
+    using Policy   = ServerCachePolicy<F>;
+    using Lookup   = typename LruCache<Value>::Lookup;
 
 private:
-    asp::Mutex<CacheMap<CacheKey, Value>> m_cache;
-    asp::Mutex<std::vector<std::pair<CacheKey, std::shared_ptr<arc::Semaphore>>>> m_syncMap;
+    // A request that is currently being sent, which anyone else asking for
+    // the same thing waits on instead of sending their own
+    struct InFlight {
+        arc::Semaphore done { 0 };
+        std::optional<Result<Value, ServerError>> result;
+    };
+
+    // Wakes up everyone waiting once the request finishes, or when it gets
+    // cancelled without a result, in which case one of them takes over
+    struct InFlightGuard {
+        FunCache& cache;
+        std::string const& key;
+        std::shared_ptr<InFlight> request;
+
+        ~InFlightGuard() {
+            auto inFlight = cache.m_inFlight.lock();
+            if (auto it = inFlight->find(key); it != inFlight->end() && it->second == request) {
+                inFlight->erase(it);
+            }
+            inFlight.unlock();
+            request->done.release(1'000'000'000);
+        }
+    };
+
+    asp::Mutex<LruCache<Value>> m_cache;
+    asp::Mutex<std::unordered_map<std::string, std::shared_ptr<InFlight>>> m_inFlight;
+    asp::Mutex<std::unordered_set<std::string>> m_revalidating;
+    // keys whose file from an earlier session was already looked for
+    asp::Mutex<std::unordered_set<std::string>> m_loadedFromDisk;
+
+    static std::string diskKey(std::string const& key) {
+        if constexpr (requires { Policy::scope(); }) {
+            return key + Policy::scope();
+        }
+        else {
+            return key;
+        }
+    }
+
+    // Reads what an earlier session stored for this key, on the blocking pool.
+    // Only done once per key, after that the memory cache is all there is
+    arc::Future<std::optional<Lookup>> loadFromDisk(std::string const& key) {
+        ARC_FRAME();
+        if (!m_loadedFromDisk.lock()->insert(key).second) {
+            co_return std::nullopt;
+        }
+
+        auto [tx, rx] = arc::oneshot::channel<std::optional<ServerCacheStore::Stored>>();
+        async::runtime().spawnBlocking<void>([diskKey = diskKey(key), tx = std::move(tx)] mutable {
+            (void) tx.send(ServerCacheStore::get().load(Policy::Name, diskKey));
+        });
+        auto received = co_await rx.recv();
+        if (!received) {
+            co_return std::nullopt;
+        }
+        auto stored = std::move(received).unwrap();
+        if (!stored) {
+            co_return std::nullopt;
+        }
+
+        auto value = Policy::parse(std::move(stored->payload));
+        if (!value) {
+            log::warn("Unable to parse cached server response: {}", value.unwrapErr());
+            co_return std::nullopt;
+        }
+        auto cache = m_cache.lock();
+        cache->add(key, std::move(value).unwrap(), stored->storedAt);
+        co_return cache->get(key);
+    }
+
+    arc::Future<> revalidate(std::string key, CacheKey args) {
+        ARC_FRAME();
+        auto res = co_await std::apply(F, std::move(args));
+        if (res) {
+            m_cache.lock()->add(key, std::move(res).unwrap());
+        }
+        else {
+            log::warn("Unable to refresh cached server response: {}", res.unwrapErr().details);
+        }
+        m_revalidating.lock()->erase(key);
+    }
 
 public:
-    FunCache() = default;
+    FunCache() {
+        m_cache.lock()->maxAge(Policy::MaxAge);
+    }
     FunCache(FunCache const&) = delete;
     FunCache(FunCache&&) = delete;
 
-    template <bool Sync, class... Args>
-    arc::Future<Result<Value, ServerError>> getInner(Args&&... args) {
+    template <class... Args>
+    arc::Future<Result<Value, ServerError>> get(Args&&... args) {
         ARC_FRAME();
-        auto key = Extract::key(args...);
+        auto key = makeCacheKey(args...);
 
-        auto cache = m_cache.lock();
-        if (auto v = cache->get(key)) {
-            co_return Ok(std::move(*v));
-        }
-        cache.unlock();
-
-        std::shared_ptr<arc::Semaphore> notify;
-        if constexpr (Sync) {
-            auto sm = m_syncMap.lock();
-            auto it = std::find_if(sm->begin(), sm->end(), [&key](auto const& q) {
-                return q.first == key;
-            });
-
-            if (it != sm->end()) {
-                // another task is already fetching this resource, synchronize with it
-                auto n = it->second;
-                sm.unlock();
-
-                co_await n->acquire(1);
-
-                // check cache again
-                auto cache = m_cache.lock();
-                if (auto v = cache->get(key)) {
-                    co_return Ok(std::move(*v));
+        if (auto v = m_cache.lock()->get(key)) {
+            if (!v->stale) {
+                co_return Ok(std::move(v->value));
+            }
+            if constexpr (Policy::Persistent) {
+                // Serve what we have and only refetch in the background
+                if (m_revalidating.lock()->insert(key).second) {
+                    async::spawn(this->revalidate(key, Extract::key(args...)));
                 }
-            } else {
-                // we are the first to fetch this resource, tell all future fetchers to wait
-                notify = std::make_shared<arc::Semaphore>(0);
-                sm->emplace_back(key, notify);
+                co_return Ok(std::move(v->value));
             }
         }
 
-        auto f = ARC_CO_UNWRAP(co_await Extract::invoke(F, std::forward<Args>(args)...));
+        while (true) {
+            auto inFlight = m_inFlight.lock();
+            if (auto it = inFlight->find(key); it != inFlight->end()) {
+                auto request = it->second;
+                inFlight.unlock();
 
-        cache.relock();
+                co_await request->done.acquire(1);
+                if (request->result) {
+                    co_return *request->result;
+                }
+                // the request was cancelled, try again
+                continue;
+            }
 
-        // only save to cache if no one beat us
-        if (!cache->has(key)) {
-            cache->add(std::move(key), Value{f});
-        }
-        cache.unlock();
+            auto request = std::make_shared<InFlight>();
+            inFlight->emplace(key, request);
+            inFlight.unlock();
 
-        // notify all waiters
-        if (notify) {
-            notify->release(1'000'000'000);
-            auto sm = m_syncMap.lock();
-            ranges::remove(*sm, [&](auto const& q) { return q.second.get() == notify.get(); });
-        }
+            InFlightGuard guard { *this, key, request };
 
-        co_return Ok(std::move(f));
-    }
+            // whoever goes first checks the disk, so everyone else waits on that too
+            if constexpr (Policy::Persistent) {
+                if (auto v = co_await this->loadFromDisk(key)) {
+                    if (v->stale && m_revalidating.lock()->insert(key).second) {
+                        async::spawn(this->revalidate(key, Extract::key(args...)));
+                    }
+                    request->result = Ok(v->value);
+                    co_return Ok(std::move(v->value));
+                }
+            }
 
-    template <class... Args>
-    arc::Future<Result<Value, ServerError>> getSynchronized(Args&&... args) {
-        return this->getInner<true>(std::forward<Args>(args)...);
+            auto res = co_await Extract::invoke(F, args...);
+            if (res) {
+                m_cache.lock()->add(key, Value{res.unwrap()});
+            }
+            request->result = res;
+            co_return res;
+        }
     }
 
+    // Called by the function itself with the raw payload of a successful
+    // response, so it can be parsed again when loaded in a later session
     template <class... Args>
-    arc::Future<Result<Value, ServerError>> get(Args&&... args) {
-        return this->getInner<false>(std::forward<Args>(args)...);
+    void persist(matjson::Value payload, Args const&... args) {
+        if constexpr (Policy::Persistent) {
+            ServerCacheStore::get().store(Policy::Name, diskKey(makeCacheKey(args...)), std::move(payload));
+        }
     }
 
     template <class... Args>
     void remove(Args const&... args) {
-        m_cache.lock()->remove(Extract::key(args...));
+        m_cache.lock()->remove(makeCacheKey(args...));
     }
 
     size_t size() {
@@ -203,6 +530,10 @@ public:
     }
     void clear() {
         m_cache.lock()->clear();
+        if constexpr (Policy::Persistent) {
+            ServerCacheStore::get().clear(Policy::Name);
+            m_loadedFromDisk.lock()->clear();
+        }
     }
 };
 
@@ -503,6 +834,28 @@ Result<ServerModUpdateAllCheck> ServerModUpdateAllCheck::parse(matjson::Value js
     });
 }
 
+matjson::Value ServerModUpdateAllCheck::toJson() const {
+    auto updatesJson = matjson::Value::array();
+    for (auto& update : updates) {
+        updatesJson.push(matjson::makeObject({
+            { "id", update.id },
+            { "version", update.version },
+        }));
+    }
+    auto deprecationsJson = matjson::Value::array();
+    for (auto& dep : deprecations) {
+        deprecationsJson.push(matjson::makeObject({
+            { "mod_id", dep.id },
+            { "by", dep.by },
+            { "reason", dep.reason },
+        }));
+    }
+    return matjson::makeObject({
+        { "updates", std::move(updatesJson) },
+        { "deprecations", std::move(deprecationsJson) },
+    });
+}
+
 Result<ServerModLinks> ServerModLinks::parse(matjson::Value raw) {
     auto payload = checkJson(std::move(raw), "ServerModLinks");
     auto res = ServerModLinks();
@@ -715,10 +1068,11 @@ ServerFuture<ServerModsList> server::getMods(ModsQuery query, bool useCache) {
             co_return Err(std::move(payload).unwrapErr());
         }
         // Parse response
-        auto list = ServerModsList::parse(std::move(payload).unwrap());
+        auto list = ServerModsList::parse(payload.unwrap());
         if (!list) {
             co_return Err(ServerError(response.code(), "Unable to parse response: {}", list.unwrapErr()));
         }
+        getCache<getMods>().persist(std::move(payload).unwrap(), query);
         co_return Ok(std::move(list).unwrap());
     }
     // Treat a 404 as empty mods list
@@ -731,7 +1085,7 @@ ServerFuture<ServerModsList> server::getMods(ModsQuery query, bool useCache) {
 ServerFuture<ServerModMetadata> server::getMod(std::string id, bool useCache) {
     ARC_FRAME();
     if (useCache) {
-        co_return co_await getCache<getMod>().getSynchronized(std::move(id));
+        co_return co_await getCache<getMod>().get(std::move(id));
     }
 
     auto req = web::WebRequest();
@@ -745,10 +1099,11 @@ ServerFuture<ServerModMetadata> server::getMod(std::string id, bool useCache) {
             co_return Err(std::move(payload).unwrapErr());
         }
         // Parse response
-        auto list = ServerModMetadata::parse(std::move(payload).unwrap());
+        auto list = ServerModMetadata::parse(payload.unwrap());
         if (!list) {
             co_return Err(ServerError(response.code(), "Unable to parse response: {}", list.unwrapErr()));
         }
+        getCache<getMod>().persist(std::move(payload).unwrap(), id);
         co_return Ok(std::move(list).unwrap());
     }
 
@@ -776,6 +1131,7 @@ ServerFuture<ServerModVersion> server::getModVersion(std::string id, ModVersion
 
     auto req = web::WebRequest();
     req.userAgent(getServerUserAgent());
+    req.httpCache(true);
 
     std::string versionURL;
     std::visit(makeVisitor {
@@ -824,6 +1180,7 @@ ServerFuture<ByteVector> server::getModLogo(std::string id, bool useCache) {
 
     auto req = web::WebRequest();
     req.userAgent(getServerUserAgent());
+    req.httpCache(true);
     auto response = co_await req.get(formatServerURL("/mods/{}/logo", id));
 
     if (response.ok()) {
@@ -847,10 +1204,11 @@ ServerFuture<std::vector<ServerTag>> server::getTags(bool useCache) {
         if (!payload) {
             co_return Err(std::move(payload).unwrapErr());
         }
-        auto list = ServerTag::parseList(std::move(payload).unwrap());
+        auto list = ServerTag::parseList(payload.unwrap());
         if (!list) {
             co_return Err(ServerError(response.code(), "Unable to parse response: {}", list.unwrapErr()));
         }
+        getCache<getTags>().persist(std::move(payload).unwrap());
         co_return Ok(std::move(list).unwrap());
     }
     co_return Err(parseServerError(response));
@@ -906,11 +1264,8 @@ ServerFuture<ServerModUpdateAllCheck> server::checkAllUpdates(bool useCache) {
     ARC_FRAME();
     if (useCache) {
         // This function is called by checkUpdates(Mod*), which means it would be called once per
-        // every single installed mod when opening ModsLayer.
-        // Because all requests start at the same time, cache is empty, and this means we spam the server with requests.
-        // The mutex here ensures that only one mod actually performs the request, and the rest will use the cached response.
-        static arc::Mutex<> mtx;
-        auto _lock = co_await mtx.lock();
+        // every single installed mod when opening ModsLayer. All of those calls start at the same
+        // time with an empty cache, so they end up sharing the one request that goes out first
         co_return co_await getCache<checkAllUpdates>().get();
     }
 
@@ -932,7 +1287,9 @@ ServerFuture<ServerModUpdateAllCheck> server::checkAllUpdates(bool useCache) {
 
     if (modCount <= maxMods) {
         // no tricks needed
-        co_return co_await batchedCheckUpdates(modIDs);
+        auto all = ARC_CO_UNWRAP(co_await batchedCheckUpdates(modIDs));
+        getCache<checkAllUpdates>().persist(all.toJson());
+        co_return Ok(std::move(all));
     }
 
     // even out the mod count, so a request with 230 mods sends two 115 mod requests
@@ -954,6 +1311,7 @@ ServerFuture<ServerModUpdateAllCheck> server::checkAllUpdates(bool useCache) {
         accum.deprecations.insert(accum.deprecations.end(), serverValues.deprecations.begin(), serverValues.deprecations.end());
     }
 
+    getCache<checkAllUpdates>().persist(accum.toJson());
     co_return Ok(std::move(accum));
 }
 
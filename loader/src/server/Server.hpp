@@ -71,6 +71,7 @@ namespace server {
         std::vector<ServerModDeprecation> deprecations;
 
         static Result<ServerModUpdateAllCheck> parse(matjson::Value json);
+        matjson::Value toJson() const;
     };
     struct ServerModUpdateOneCheck final {
         std::optional<ServerModUpdate> update;
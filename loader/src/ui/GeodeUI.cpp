@@ -241,7 +241,6 @@ class ModLogoSprite : public CCNodeRGBA {
 protected:
     LazySprite* m_sprite;
     std::string m_modID;
-    async::TaskHolder<Result<ByteVector, server::ServerError>> m_listener;
 
     bool init(ModLogoSrc&& src) {
         if (!CCNode::init())
@@ -292,13 +291,16 @@ protected:
             [this](std::string const& id) {
                 m_modID = id;
 
-                // Asynchronously fetch from server
-                m_listener.spawn(
-                    server::getModLogo(id),
-                    [this](auto result) {
-                        this->onFetch(std::move(result));
-                    }
-                );
+                m_sprite->setLoadCallback([this](Result<> res) {
+                    this->onLoaded(std::move(res));
+                });
+
+                // Mod lists create a lot of these, so only fetch the ones that are scrolled
+                // into view. Loaded logos stay in the texture cache for when a page is rebuilt
+                m_sprite->setDeferUntilVisible(true);
+                m_sprite->loadFromFuture(fmt::format("geode-mod-logo:{}", id), [id] {
+                    return fetchLogo(id);
+                });
             },
             [this](std::filesystem::path const& path) {
                 m_sprite->setLoadCallback([this](Result<> res) {
@@ -330,6 +332,15 @@ protected:
         ModLogoUIEvent().send(this, m_modID, std::nullopt);
     }
 
+    // goes through the server layer for its user agent and caches
+    static arc::Future<Result<ByteVector>> fetchLogo(std::string id) {
+        auto res = co_await server::getModLogo(std::move(id));
+        if (!res) {
+            co_return Err(std::move(res).unwrapErr().details);
+        }
+        co_return Ok(std::move(res).unwrap());
+    }
+
     void onLoaded(Result<> res) {
         if (!res) {
             log::debug("Failed to load image: {}", res.err().value_or(std::string{}));
@@ -352,20 +363,6 @@ protected:
         this->doPostEvent();
     }
 
-    void onFetch(Result<ByteVector, server::ServerError> result) {
-        // Set default sprite on error
-        if (result.isErr()) {
-            this->onLoadFailed(true);
-        }
-        // Otherwise load downloaded sprite to memory
-        else {
-            m_sprite->setLoadCallback([this](Result<> res) {
-                this->onLoaded(std::move(res));
-            });
-            m_sprite->loadFromData(std::move(result).unwrap());
-        }
-    }
-
 public:
     static ModLogoSprite* create(ModLogoSrc&& src) {
         auto ret = new ModLogoSprite();
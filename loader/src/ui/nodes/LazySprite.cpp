@@ -1,4 +1,5 @@
 #include <Geode/ui/LazySprite.hpp>
+#include <Geode/binding/CCScrollLayerExt.hpp>
 #include <Geode/utils/string.hpp>
 #include <Geode/utils/web.hpp>
 #include <Geode/utils/file.hpp>
@@ -12,9 +13,12 @@ public:
     Callback m_callback;
     Format m_expectedFormat;
     async::TaskHolder<web::WebResponse> m_listener;
+    async::TaskHolder<Result<ByteVector>> m_futureListener;
     bool m_isLoading = false;
     std::atomic_bool m_hasLoaded = false;
     bool m_autoresize;
+    bool m_deferUntilVisible = false;
+    Function<void()> m_pendingLoad;
     cocos2d::CCSize m_targetSize;
     LazySprite* m_self;
 
@@ -22,6 +26,11 @@ public:
 
     bool init(cocos2d::CCSize size, bool loadingCircle = true);
     void doInitFromBytes(std::vector<uint8_t> data, std::string cacheKey);
+    void startLoad(Function<void()> load);
+    bool isOnScreen();
+    void loadUrl(std::string url, bool ignoreCache);
+    void uploadTexture(cocos2d::CCImage* image, std::string const& cacheKey);
+    void loadFile(std::filesystem::path path, std::string cacheKey);
     std::string makeCacheKey(std::filesystem::path const& path);
     // std::string makeCacheKey(std::string_view url);
 
@@ -73,9 +82,17 @@ void LazySprite::loadFromUrl(std::string url, Format format, bool ignoreCache) {
     m_impl->m_expectedFormat = format;
     m_impl->m_isLoading = true;
 
-    m_impl->m_listener.spawn(
+    m_impl->startLoad([this, url = std::move(url), ignoreCache] mutable {
+        m_impl->loadUrl(std::move(url), ignoreCache);
+    });
+}
+
+void LazySprite::Impl::loadUrl(std::string url, bool ignoreCache) {
+    // images are kept between sessions by the HTTP cache, which revalidates
+    // them with the server once they go stale
+    m_listener.spawn(
         "LazySprite Web Listener",
-        web::WebRequest{}.get(url),
+        web::WebRequest{}.httpCache(!ignoreCache).get(url),
         [this, cacheKey = ignoreCache ? std::string{} : std::string(url)](web::WebResponse resp) mutable {
             if (!resp.ok()) {
                 std::string errmsg(resp.errorMessage());
@@ -88,7 +105,7 @@ void LazySprite::loadFromUrl(std::string url, Format format, bool ignoreCache) {
                     errmsg += "...";
                 }
     
-                this->m_impl->onError(fmt::format(
+                this->onError(fmt::format(
                     "Request failed (code {}): {}",
                     resp.code(),
                     errmsg
@@ -97,7 +114,7 @@ void LazySprite::loadFromUrl(std::string url, Format format, bool ignoreCache) {
                 return;
             }
     
-            this->m_impl->doInitFromBytes(std::move(resp).data(), std::move(cacheKey));
+            this->doInitFromBytes(std::move(resp).data(), std::move(cacheKey));
         }
     );
 }
@@ -115,9 +132,15 @@ void LazySprite::loadFromFile(const std::filesystem::path& path, Format format,
     m_impl->m_expectedFormat = format;
     m_impl->m_isLoading = true;
 
+    m_impl->startLoad([this, path = path, cacheKey = std::move(cacheKey)] mutable {
+        m_impl->loadFile(std::move(path), std::move(cacheKey));
+    });
+}
+
+void LazySprite::Impl::loadFile(std::filesystem::path path, std::string cacheKey) {
     async::runtime().spawnBlocking<void>([
-        selfref = WeakRef(this),
-        path = path,
+        selfref = WeakRef(m_self),
+        path = std::move(path),
         cacheKey = std::move(cacheKey)
     ] mutable {
         auto res = utils::file::readBinary(path);
@@ -144,6 +167,33 @@ void LazySprite::loadFromFile(const std::filesystem::path& path, Format format,
     });
 }
 
+void LazySprite::loadFromFuture(std::string cacheKey, Function<arc::Future<Result<ByteVector>>()> makeFuture, Format format) {
+    if (m_impl->m_isLoading || m_impl->m_hasLoaded) {
+        return;
+    }
+
+    if (!cacheKey.empty() && m_impl->initFromCache(cacheKey.c_str())) {
+        return;
+    }
+
+    m_impl->m_expectedFormat = format;
+    m_impl->m_isLoading = true;
+
+    m_impl->startLoad([this, cacheKey = std::move(cacheKey), makeFuture = std::move(makeFuture)] mutable {
+        m_impl->m_futureListener.spawn(
+            "LazySprite Future Listener",
+            makeFuture(),
+            [this, cacheKey = std::move(cacheKey)](Result<ByteVector> res) mutable {
+                if (!res) {
+                    m_impl->onError(std::move(res).unwrapErr());
+                    return;
+                }
+                m_impl->doInitFromBytes(std::move(res).unwrap(), std::move(cacheKey));
+            }
+        );
+    });
+}
+
 void LazySprite::loadFromData(std::vector<uint8_t> data, Format format) {
     if (m_impl->m_isLoading || m_impl->m_hasLoaded) {
         return;
@@ -197,32 +247,78 @@ void LazySprite::Impl::doInitFromBytes(std::vector<uint8_t> data, std::string ca
             cacheKey = std::move(cacheKey)
         ] {
             auto self = selfref.lock();
-            if (!self || !self->m_impl->m_isLoading) return;
-
-            auto texture = new CCTexture2D();
-            if (!texture->initWithImage(image)) {
-                delete texture;
+            if (!self || !self->m_impl->m_isLoading) {
                 image->release();
-                self->m_impl->onError("failed to initialize OpenGL texture");
                 return;
             }
+            self->m_impl->uploadTexture(image, cacheKey);
+        });
+    });
+}
+
+// ! This function must be invoked on main thread !
+void LazySprite::Impl::uploadTexture(CCImage* image, std::string const& cacheKey) {
+    auto texture = new CCTexture2D();
+    if (!texture->initWithImage(image)) {
+        delete texture;
+        image->release();
+        this->onError("failed to initialize OpenGL texture");
+        return;
+    }
 
-            image->release(); // deallocate the image, not needed anymore
+    image->release(); // deallocate the image, not needed anymore
 
-            // store texture
-            if (!cacheKey.empty()) {
-                CCTextureCache::get()->m_pTextures->setObject(texture, cacheKey.c_str());
-            }
+    // store texture
+    if (!cacheKey.empty()) {
+        CCTextureCache::get()->m_pTextures->setObject(texture, cacheKey.c_str());
+    }
 
-            // this is weird but don't touch it unless you should
-            if (!self->CCSprite::initWithTexture(texture)) {
-                // this should never happen tbh
-                self->m_impl->onError("failed to initialize the sprite");
-            }
+    // this is weird but don't touch it unless you should
+    if (!m_self->CCSprite::initWithTexture(texture)) {
+        // this should never happen tbh
+        this->onError("failed to initialize the sprite");
+    }
 
-            texture->release(); // bring texture's refcount back to 1
-        });
-    });
+    texture->release(); // bring texture's refcount back to 1
+}
+
+void LazySprite::Impl::startLoad(Function<void()> load) {
+    if (!m_deferUntilVisible || this->isOnScreen()) {
+        load();
+        return;
+    }
+    // picked up by visit() once the sprite shows up
+    m_pendingLoad = std::move(load);
+}
+
+static CCRect worldBounds(CCNode* node) {
+    auto a = node->convertToWorldSpace(CCPointZero);
+    auto b = node->convertToWorldSpace(node->getContentSize());
+    return CCRect(
+        std::min(a.x, b.x), std::min(a.y, b.y),
+        std::abs(b.x - a.x), std::abs(b.y - a.y)
+    );
+}
+
+bool LazySprite::Impl::isOnScreen() {
+    if (!m_self->isRunning() || !nodeIsVisible(m_self)) {
+        return false;
+    }
+    auto rect = worldBounds(m_self);
+    auto winSize = CCDirector::get()->getWinSize();
+    if (!rect.intersectsRect(CCRect(0, 0, winSize.width, winSize.height))) {
+        return false;
+    }
+    // lists cut off everything that's scrolled out of them, which is most of what's in them
+    for (auto parent = m_self->getParent(); parent; parent = parent->getParent()) {
+        auto scroll = typeinfo_cast<CCScrollLayerExt*>(parent);
+        if ((scroll && scroll->m_cutContent) || typeinfo_cast<CCClippingNode*>(parent)) {
+            if (!rect.intersectsRect(worldBounds(parent))) {
+                return false;
+            }
+        }
+    }
+    return true;
 }
 
 std::string LazySprite::Impl::makeCacheKey(std::filesystem::path const& path) {
@@ -313,8 +409,27 @@ bool LazySprite::isLoading() {
     return m_impl->m_isLoading;
 }
 
+void LazySprite::setDeferUntilVisible(bool value) {
+    m_impl->m_deferUntilVisible = value;
+}
+
+void LazySprite::visit() {
+    if (m_impl->m_pendingLoad && m_impl->isOnScreen()) {
+        // start on the next frame rather than in the middle of drawing
+        Loader::get()->queueInMainThread([selfref = WeakRef(this), load = std::move(m_impl->m_pendingLoad)] mutable {
+            auto self = selfref.lock();
+            if (self && self->m_impl->m_isLoading) {
+                load();
+            }
+        });
+        m_impl->m_pendingLoad = nullptr;
+    }
+    CCSprite::visit();
+}
+
 void LazySprite::cancelLoad() {
     m_impl->m_isLoading = false;
+    m_impl->m_pendingLoad = nullptr;
 
     if (m_impl->m_loadingCircle) {
         m_impl->m_loadingCircle->removeFromParent();
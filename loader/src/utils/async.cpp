@@ -1,8 +1,10 @@
 #include <Geode/utils/async.hpp>
 #include <Geode/loader/GameEvent.hpp>
 #include <Geode/loader/Log.hpp>
+#include <Geode/utils/Task.hpp>
 #include <Geode/utils/terminate.hpp>
 #include <loader/LogImpl.hpp>
+#include <thread>
 
 using namespace geode::prelude;
 
@@ -36,6 +38,24 @@ arc::Runtime& runtime() {
 
 }
 
+namespace geode::geode_internal {
+
+void runTaskBody(geode::Function<void()> body) {
+    // tasks may still be started while the game is closing, after the runtime is gone
+    if (auto& rt = async::runtimePtr()) {
+        rt->spawnBlocking<void>([body = std::move(body)] mutable {
+            body();
+        });
+    }
+    else {
+        std::thread([body = std::move(body)] mutable {
+            body();
+        }).detach();
+    }
+}
+
+}
+
 $on_mod(Loaded) {
     GameEvent(GameEventType::Exiting).listen([] {
         log::info("Shutting down logger and async runtime..");
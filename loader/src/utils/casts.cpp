@@ -0,0 +1,77 @@
+#include <Geode/platform/platform.hpp>
+
+#if defined(GEODE_IS_ANDROID) || defined(GEODE_IS_MACOS) || defined(GEODE_IS_IOS)
+
+#include <atomic>
+
+using namespace geode::cast;
+
+namespace {
+    class TypeinfoCastCache {
+    private:
+        static constexpr size_t SLOT_COUNT = 2048;
+        static constexpr size_t MAX_PROBES = 8;
+
+        // entries are immutable once published and live for the rest of the
+        // process, so readers don't need to take any locks
+        std::atomic<TypeinfoCastCacheEntry const*> m_slots[SLOT_COUNT] = {};
+
+        static size_t indexFor(VtableType const* vtable, ClassTypeinfoType const* afterTypeinfo) {
+            size_t hash = reinterpret_cast<uintptr_t>(vtable) >> 3;
+            hash ^= (reinterpret_cast<uintptr_t>(afterTypeinfo) >> 3) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            return hash % SLOT_COUNT;
+        }
+
+    public:
+        static TypeinfoCastCache& get() {
+            static TypeinfoCastCache inst;
+            return inst;
+        }
+
+        TypeinfoCastCacheEntry const* find(VtableType const* vtable, ClassTypeinfoType const* afterTypeinfo) const {
+            auto index = indexFor(vtable, afterTypeinfo);
+            for (size_t i = 0; i < MAX_PROBES; ++i) {
+                auto entry = m_slots[(index + i) % SLOT_COUNT].load(std::memory_order_acquire);
+                if (!entry) {
+                    return nullptr;
+                }
+                if (entry->m_vtable == vtable && entry->m_afterTypeinfo == afterTypeinfo) {
+                    return entry;
+                }
+            }
+            return nullptr;
+        }
+
+        void insert(VtableType const* vtable, ClassTypeinfoType const* afterTypeinfo, std::ptrdiff_t offset, bool found) {
+            auto entry = new TypeinfoCastCacheEntry{vtable, afterTypeinfo, offset, found};
+            auto index = indexFor(vtable, afterTypeinfo);
+            for (size_t i = 0; i < MAX_PROBES; ++i) {
+                TypeinfoCastCacheEntry const* expected = nullptr;
+                auto& slot = m_slots[(index + i) % SLOT_COUNT];
+                if (slot.compare_exchange_strong(expected, entry, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    return;
+                }
+                // another thread resolved the same cast first
+                if (expected->m_vtable == vtable && expected->m_afterTypeinfo == afterTypeinfo) {
+                    break;
+                }
+            }
+            // either a duplicate or this neighbourhood is full, just don't cache it
+            delete entry;
+        }
+    };
+}
+
+TypeinfoCastCacheEntry const* geode::cast::findCachedTypeinfoCast(
+    VtableType const* vtable, ClassTypeinfoType const* afterTypeinfo
+) {
+    return TypeinfoCastCache::get().find(vtable, afterTypeinfo);
+}
+
+void geode::cast::cacheTypeinfoCast(
+    VtableType const* vtable, ClassTypeinfoType const* afterTypeinfo, std::ptrdiff_t offset, bool found
+) {
+    TypeinfoCastCache::get().insert(vtable, afterTypeinfo, offset, found);
+}
+
+#endif
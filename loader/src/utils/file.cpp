@@ -11,6 +11,12 @@
 #include <mz_strm_mem.h>
 #include <mz_zip.h>
 #include <Geode/utils/ranges.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <limits>
+#include <thread>
+#include <unordered_set>
 
 #ifdef GEODE_IS_WINDOWS
 # include <filesystem>
@@ -18,6 +24,7 @@
 # include <unistd.h>
 # include <fcntl.h>
 # include <sys/stat.h>
+# include <sys/mman.h>
 #endif
 
 #if defined(GEODE_IS_ANDROID) || defined(GEODE_IS_MACOS) || defined(GEODE_IS_IOS)
@@ -135,6 +142,66 @@ static Result<> writeFileFrom(std::filesystem::path const& path, void* data, siz
     return Ok();
 }
 
+// read-only view of a whole file mapped into memory
+class MappedFile final {
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+    uint8_t const* m_data = nullptr;
+    size_t m_size = 0;
+
+public:
+    MappedFile() = default;
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    ~MappedFile() {
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+    }
+
+    static Result<std::unique_ptr<MappedFile>> open(std::filesystem::path const& path) {
+        auto ret = std::make_unique<MappedFile>();
+        ret->m_file = CreateFileW(
+            path.c_str(),
+            GENERIC_READ,
+            // let updaters and antivirus rename or delete the file while it's mapped
+            FILE_SHARE_READ | FILE_SHARE_DELETE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr
+        );
+        if (ret->m_file == INVALID_HANDLE_VALUE) {
+            return Err("Unable to open file: {}", formatError());
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(ret->m_file, &size)) {
+            return Err("Unable to get file size: {}", formatError());
+        }
+        // empty files can't be mapped
+        if (size.QuadPart == 0) {
+            return Err("File is empty");
+        }
+        ret->m_size = static_cast<size_t>(size.QuadPart);
+
+        ret->m_mapping = CreateFileMappingW(ret->m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!ret->m_mapping) {
+            return Err("Unable to map file: {}", formatError());
+        }
+        ret->m_data = static_cast<uint8_t const*>(MapViewOfFile(ret->m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!ret->m_data) {
+            return Err("Unable to map file: {}", formatError());
+        }
+        return Ok(std::move(ret));
+    }
+
+    ByteSpan data() const {
+        return ByteSpan(m_data, m_size);
+    }
+};
+
 #else
 
 template <typename T>
@@ -189,6 +256,53 @@ static Result<> writeFileFrom(std::filesystem::path const& path, void* data, siz
     return Ok();
 }
 
+// read-only view of a whole file mapped into memory
+class MappedFile final {
+    void* m_data = MAP_FAILED;
+    size_t m_size = 0;
+
+public:
+    MappedFile() = default;
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    ~MappedFile() {
+        if (m_data != MAP_FAILED) munmap(m_data, m_size);
+    }
+
+    static Result<std::unique_ptr<MappedFile>> open(std::filesystem::path const& path) {
+        int file = ::open(path.c_str(), O_RDONLY);
+        if (file == -1) {
+            return Err("Unable to open file: {}", formatError());
+        }
+
+        struct stat fst;
+        if (fstat(file, &fst) == -1) {
+            close(file);
+            return Err("Unable to get file size: {}", formatError());
+        }
+        // empty files can't be mapped
+        if (fst.st_size == 0) {
+            close(file);
+            return Err("File is empty");
+        }
+
+        auto ret = std::make_unique<MappedFile>();
+        ret->m_size = static_cast<size_t>(fst.st_size);
+        ret->m_data = mmap(nullptr, ret->m_size, PROT_READ, MAP_PRIVATE, file, 0);
+        // the mapping stays valid after the descriptor is closed
+        close(file);
+        if (ret->m_data == MAP_FAILED) {
+            return Err("Unable to map file: {}", formatError());
+        }
+        return Ok(std::move(ret));
+    }
+
+    ByteSpan data() const {
+        return ByteSpan(static_cast<uint8_t const*>(m_data), m_size);
+    }
+};
+
 #endif
 
 Result<std::string> utils::file::readString(std::filesystem::path const& path) {
@@ -337,6 +451,78 @@ struct ZipEntry {
     bool isDirectory;
     int64_t compressedSize;
     int64_t uncompressedSize;
+    uint32_t crc32;
+    // position in the central directory, for jumping straight to the entry
+    int64_t cdPos;
+};
+
+// entries are streamed to disk in chunks of this size, no matter how large they are
+static constexpr size_t ZIP_EXTRACT_CHUNK_SIZE = 256 * 1024;
+// archives are extracted on at most this many threads
+static constexpr size_t ZIP_EXTRACT_MAX_THREADS = 4;
+// below this many files it's not worth opening extra handles
+static constexpr size_t ZIP_EXTRACT_PARALLEL_THRESHOLD = 8;
+
+// an extra read handle onto an archive, since a single minizip handle can't be shared between threads
+class ZipReadHandle final {
+    void* m_handle = nullptr;
+    void* m_stream = nullptr;
+
+public:
+    ZipReadHandle() = default;
+    ZipReadHandle(ZipReadHandle const&) = delete;
+    ZipReadHandle& operator=(ZipReadHandle const&) = delete;
+
+    ~ZipReadHandle() {
+        if (m_handle) {
+            mz_zip_close(m_handle);
+            mz_zip_delete(&m_handle);
+        }
+        if (m_stream) {
+            mz_stream_close(m_stream);
+            mz_stream_delete(&m_stream);
+        }
+    }
+
+    Result<> open(std::filesystem::path const& path) {
+        m_stream = mz_stream_os_create();
+        if (!m_stream) {
+            return Err("Unable to open file");
+        }
+        auto pathstr = utils::string::pathToString(path);
+        if (mz_stream_os_open(m_stream, pathstr.c_str(), MZ_OPEN_MODE_READ) != MZ_OK) {
+            return Err("Unable to read file");
+        }
+        return this->openZip();
+    }
+
+    Result<> open(ByteSpan data) {
+        // the buffer is only ever read from, so all handles can share it
+        m_stream = mz_stream_mem_create();
+        if (!m_stream) {
+            return Err("Unable to create memory stream");
+        }
+        mz_stream_mem_set_buffer(m_stream, const_cast<uint8_t*>(data.data()), data.size());
+        if (mz_stream_open(m_stream, nullptr, MZ_OPEN_MODE_READ) != MZ_OK) {
+            return Err("Unable to read memory stream");
+        }
+        return this->openZip();
+    }
+
+    Result<> openZip() {
+        m_handle = mz_zip_create();
+        if (!m_handle) {
+            return Err("Unable to create zip handler");
+        }
+        if (mz_zip_open(m_handle, m_stream, MZ_OPEN_MODE_READ) != MZ_OK) {
+            return Err("Unable to open zip");
+        }
+        return Ok();
+    }
+
+    void* get() const {
+        return m_handle;
+    }
 };
 
 class Zip::Impl final {
@@ -348,12 +534,21 @@ private:
     void* m_stream = nullptr;
     int32_t m_mode;
     std::variant<Path, ByteVector> m_srcDest;
+    // zips opened for reading from disk are mapped into memory when possible
+    std::unique_ptr<MappedFile> m_mapping;
     std::unordered_map<Path, ZipEntry, path_hash_t> m_entries;
     geode::Function<void(uint32_t, uint32_t)> m_progressCallback;
 
     Result<> init() {
+        if (std::holds_alternative<Path>(m_srcDest) && m_mode == MZ_OPEN_MODE_READ) {
+            auto mapping = MappedFile::open(std::get<Path>(m_srcDest));
+            if (mapping) {
+                m_mapping = std::move(mapping).unwrap();
+            }
+        }
+
         // open stream from file
-        if (std::holds_alternative<Path>(m_srcDest)) {
+        if (std::holds_alternative<Path>(m_srcDest) && !m_mapping) {
             auto& path = std::get<Path>(m_srcDest);
             // open file
             m_stream = mz_stream_os_create();
@@ -371,6 +566,18 @@ private:
                 return Err("Unable to read file");
             }
         }
+        // open stream from mapped file
+        else if (m_mapping) {
+            m_stream = mz_stream_mem_create();
+            if (!m_stream) {
+                return Err("Unable to create memory stream");
+            }
+            auto data = m_mapping->data();
+            mz_stream_mem_set_buffer(m_stream, const_cast<uint8_t*>(data.data()), data.size());
+            if (mz_stream_open(m_stream, nullptr, m_mode) != MZ_OK) {
+                return Err("Unable to read mapped file");
+            }
+        }
         // open stream from memory stream
         else {
             auto& src = std::get<ByteVector>(m_srcDest);
@@ -426,6 +633,8 @@ private:
                 .isDirectory = mz_zip_entry_is_dir(m_handle) == MZ_OK,
                 .compressedSize = info->compressed_size,
                 .uncompressedSize = info->uncompressed_size,
+                .crc32 = info->crc,
+                .cdPos = mz_zip_get_entry(m_handle),
             } });
 
             err = mz_zip_goto_next_entry(m_handle);
@@ -452,9 +661,12 @@ public:
     }
 
     static Result<std::unique_ptr<Impl>> fromMemory(ByteSpan raw) {
+        return fromMemory(ByteVector{raw.begin(), raw.end()});
+    }
+    static Result<std::unique_ptr<Impl>> fromMemory(ByteVector&& raw) {
         auto ret = std::make_unique<Impl>();
         ret->m_mode = MZ_OPEN_MODE_READ;
-        ret->m_srcDest = ByteVector{raw.begin(), raw.end()};
+        ret->m_srcDest = std::move(raw);
         GEODE_UNWRAP(ret->init());
         return Ok(std::move(ret));
     }
@@ -471,128 +683,227 @@ public:
         m_progressCallback = std::move(callback);
     }
 
-    Result<> extractAt(Path const& dir, Path const& name) {
-        auto entry = m_entries.at(name);
-
+    static Result<> streamEntry(void* handle, ZipEntry const& entry, Path const& target, char* buffer) {
         GEODE_UNWRAP(
-            mzTry(mz_zip_entry_read_open(m_handle, 0, nullptr))
+            mzTry(mz_zip_goto_entry(handle, entry.cdPos))
+            .mapErr([&](auto error) {
+                return fmt::format("Unable to navigate to entry (code {})", error);
+            })
+        );
+        GEODE_UNWRAP(
+            mzTry(mz_zip_entry_read_open(handle, 0, nullptr))
             .mapErr([&](auto error) {
                 return fmt::format("Unable to open entry (code {})", error);
             })
         );
 
-        // if the file is empty, its data is empty (duh)
-        if (!entry.uncompressedSize) {
-            return Ok();
+        std::ofstream out(target, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            mz_zip_entry_close(handle);
+            return Err("Unable to open {} for writing", target);
         }
 
-        ByteVector res;
-        res.resize(entry.uncompressedSize);
-        auto read = mz_zip_entry_read(m_handle, res.data(), entry.uncompressedSize);
-        if (read < 0) {
-            mz_zip_entry_close(m_handle);
-            return Err("Unable to read entry (code {})", read);
+        while (true) {
+            auto read = mz_zip_entry_read(handle, buffer, ZIP_EXTRACT_CHUNK_SIZE);
+            if (read < 0) {
+                mz_zip_entry_close(handle);
+                return Err("Unable to read entry (code {})", read);
+            }
+            if (read == 0) {
+                break;
+            }
+            if (!out.write(buffer, read)) {
+                mz_zip_entry_close(handle);
+                return Err("Unable to write to {}", target);
+            }
         }
 
-        mz_zip_entry_close(m_handle);
-
-        GEODE_UNWRAP(file::createDirectoryAll((dir / name).parent_path()));
-        GEODE_UNWRAP(file::writeBinary(dir / name, res).mapErr([&](auto error) {
-            return fmt::format("Unable to write to {}: {}", dir / name, error);
-        }));
-
+        mz_zip_entry_close(handle);
         return Ok();
     }
 
-    Result<> extractAllTo(Path const& dir) {
-        GEODE_UNWRAP(file::createDirectoryAll(dir));
-
-        GEODE_UNWRAP(
-            mzTry(mz_zip_goto_first_entry(m_handle))
-            .mapErr([&](auto error) {
-                return fmt::format("Unable to navigate to first entry (code {})", error);
-            })
-        );
-
-        uint64_t numEntries;
+    Result<> extractTo(Path const& name, Path const& target) {
+        auto it = m_entries.find(name);
+        if (it == m_entries.end()) {
+            return Err("Entry not found");
+        }
+        if (it->second.isDirectory) {
+            return Err("Entry is directory");
+        }
+        auto buffer = std::make_unique<char[]>(ZIP_EXTRACT_CHUNK_SIZE);
+        return streamEntry(m_handle, it->second, target, buffer.get());
+    }
 
-        GEODE_UNWRAP(
-            mzTry(mz_zip_get_number_entry(m_handle, &numEntries))
-            .mapErr([&](auto error) {
-                return fmt::format("Unable to get number of entries (code {})", error);
-            })
-        );
+    Result<> extractAllTo(Path const& dir, geode::Function<bool(Path const&)> filter = nullptr) {
+        GEODE_UNWRAP(file::createDirectoryAll(dir));
 
-        uint32_t currentEntry = 0;
-        // while not at MZ_END_OF_LIST
-        do {
-            mz_zip_file* info = nullptr;
-            if (mz_zip_entry_get_info(m_handle, &info) != MZ_OK) {
-                return Err("Unable to get entry info");
+        struct Job {
+            ZipEntry const* entry;
+            Path target;
+        };
+        std::vector<Job> jobs;
+
+        uint32_t total = static_cast<uint32_t>(m_entries.size());
+        uint32_t current = 0;
+        auto reportProgress = [&] {
+            if (m_progressCallback) {
+                m_progressCallback(current, total);
             }
-            currentEntry++;
-
-            Path filePath;
-            filePath.assign(info->filename, info->filename + info->filename_size);
+        };
 
+        // create every directory up front, so workers only ever write files
+        std::unordered_set<Path, path_hash_t> directories;
+        for (auto& [name, entry] : m_entries) {
             // make sure zip files like root/../../file.txt don't get extracted to
             // avoid zip attacks
-            std::error_code ec;
-            auto safePath = safePathJoin(dir, filePath);
+            auto safePath = safePathJoin(dir, name);
+            if (safePath.empty()) {
+                log::error(
+                    "Zip entry '{}' is not contained within zip bounds",
+                    name
+                );
+                current++;
+                continue;
+            }
 
-            if (!safePath.empty()) {
-                if (m_entries.at(filePath).isDirectory) {
+            if (filter && !filter(name)) {
+                current++;
+                continue;
+            }
+
+            if (entry.isDirectory) {
+                if (directories.insert(safePath).second) {
                     GEODE_UNWRAP(file::createDirectoryAll(safePath));
                 }
-                else {
-                    GEODE_UNWRAP(this->extractAt(dir, filePath));
+                current++;
+                reportProgress();
+            }
+            else {
+                auto parent = safePath.parent_path();
+                if (directories.insert(parent).second) {
+                    GEODE_UNWRAP(file::createDirectoryAll(parent));
                 }
-                if (m_progressCallback) {
-                    m_progressCallback(currentEntry, numEntries);
+                jobs.push_back({ &entry, std::move(safePath) });
+            }
+        }
+
+        // biggest entries first, so one large file doesn't end up last on a single thread
+        std::sort(jobs.begin(), jobs.end(), [](Job const& a, Job const& b) {
+            return a.entry->uncompressedSize > b.entry->uncompressedSize;
+        });
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::atomic_size_t next = 0;
+        std::atomic_bool failed = false;
+        std::optional<std::string> error;
+        size_t finished = 0;
+
+        auto work = [&](void* handle) {
+            auto buffer = std::make_unique<char[]>(ZIP_EXTRACT_CHUNK_SIZE);
+            while (!failed) {
+                auto i = next.fetch_add(1);
+                if (i >= jobs.size()) break;
+
+                auto res = streamEntry(handle, *jobs[i].entry, jobs[i].target, buffer.get());
+
+                std::lock_guard lock(mutex);
+                if (!res && !error) {
+                    error = fmt::format("Unable to extract {}: {}", jobs[i].target, res.unwrapErr());
+                    failed = true;
                 }
+                finished++;
+                cv.notify_one();
+            }
+        };
+
+        auto threadCount = std::min<size_t>({
+            std::max(std::thread::hardware_concurrency(), 1u), ZIP_EXTRACT_MAX_THREADS, jobs.size()
+        });
+        if (jobs.size() < ZIP_EXTRACT_PARALLEL_THRESHOLD) {
+            threadCount = 1;
+        }
+
+        if (threadCount <= 1) {
+            auto buffer = std::make_unique<char[]>(ZIP_EXTRACT_CHUNK_SIZE);
+            for (auto& job : jobs) {
+                GEODE_UNWRAP(streamEntry(m_handle, *job.entry, job.target, buffer.get()).mapErr([&](auto error) {
+                    return fmt::format("Unable to extract {}: {}", job.target, error);
+                }));
+                current++;
+                reportProgress();
+            }
+            return Ok();
+        }
+
+        // every worker needs its own handle, and the progress callback
+        // stays on this thread since it's not thread-safe
+        std::vector<std::unique_ptr<ZipReadHandle>> handles;
+        for (size_t i = 0; i < threadCount; i++) {
+            auto handle = std::make_unique<ZipReadHandle>();
+            if (m_mapping) {
+                GEODE_UNWRAP(handle->open(m_mapping->data()));
+            }
+            else if (auto data = std::get_if<ByteVector>(&m_srcDest)) {
+                GEODE_UNWRAP(handle->open(ByteSpan(*data)));
             }
             else {
-                log::error(
-                    "Zip entry '{}' is not contained within zip bounds",
-                    filePath
-                );
+                GEODE_UNWRAP(handle->open(std::get<Path>(m_srcDest)));
+            }
+            handles.push_back(std::move(handle));
+        }
+
+        std::vector<std::thread> workers;
+        for (auto& handle : handles) {
+            workers.emplace_back(work, handle->get());
+        }
 
-                if (ec) {
-                    return Err(fmt::format("Unable to check relative: {}", ec.message()));
+        size_t reported = 0;
+        {
+            std::unique_lock lock(mutex);
+            while (true) {
+                cv.wait(lock, [&] { return finished != reported || failed; });
+                if (failed) break;
+                auto newlyFinished = finished - reported;
+                reported = finished;
+
+                lock.unlock();
+                for (size_t i = 0; i < newlyFinished; i++) {
+                    current++;
+                    reportProgress();
                 }
+                lock.lock();
+
+                if (reported == jobs.size()) break;
             }
-        } while (mz_zip_goto_next_entry(m_handle) == MZ_OK);
+        }
 
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        if (error) {
+            return Err(std::move(*error));
+        }
         return Ok();
     }
 
     Result<ByteVector> extract(Path const& name) {
-        if (!m_entries.count(name)) {
+        auto it = m_entries.find(name);
+        if (it == m_entries.end()) {
             return Err("Entry not found");
         }
 
-        auto entry = m_entries.at(name);
+        auto& entry = it->second;
         if (entry.isDirectory) {
             return Err("Entry is directory");
         }
 
+        // jump straight to the entry instead of scanning the central directory for it
         GEODE_UNWRAP(
-            mzTry(mz_zip_goto_first_entry(m_handle))
-            .mapErr([&](auto error) {
-                return fmt::format("Unable to navigate to first entry (code {})", error);
-            })
-        );
-
-        auto namestr = utils::string::pathToString(name);
-
-        GEODE_UNWRAP(
-            mzTry(mz_zip_locate_entry(
-                m_handle,
-                namestr.c_str(),
-                1
-            ))
+            mzTry(mz_zip_goto_entry(m_handle, entry.cdPos))
             .mapErr([&](auto error) {
-                return fmt::format("Unable to locate entry (code {})", error);
+                return fmt::format("Unable to navigate to entry (code {})", error);
             })
         );
 
@@ -603,21 +914,33 @@ public:
             })
         );
 
-        // if the file is empty, its data is empty (duh)
-        if (!entry.uncompressedSize) {
-            return Ok(ByteVector());
-        }
-
         ByteVector res;
-        res.resize(entry.uncompressedSize);
-        auto read = mz_zip_entry_read(m_handle, res.data(), entry.uncompressedSize);
-        if (read < 0) {
+        if (entry.uncompressedSize < 0 || static_cast<uint64_t>(entry.uncompressedSize) > res.max_size()) {
             mz_zip_entry_close(m_handle);
-            return Err("Unable to read entry (code {})", read);
+            return Err("Entry is too large to extract into memory ({} bytes)", entry.uncompressedSize);
+        }
+        res.resize(static_cast<size_t>(entry.uncompressedSize));
+        size_t offset = 0;
+        while (offset < res.size()) {
+            // minizip reads at most INT32_MAX bytes per call
+            auto chunk = std::min<size_t>(res.size() - offset, std::numeric_limits<int32_t>::max());
+            auto read = mz_zip_entry_read(m_handle, res.data() + offset, static_cast<int32_t>(chunk));
+            if (read < 0) {
+                mz_zip_entry_close(m_handle);
+                return Err("Unable to read entry (code {})", read);
+            }
+            if (read == 0) {
+                break;
+            }
+            offset += read;
         }
         mz_zip_entry_close(m_handle);
 
-        return Ok(res);
+        if (offset < res.size()) {
+            return Err("Unable to read entire entry: only read {} of {}", offset, res.size());
+        }
+
+        return Ok(std::move(res));
     }
 
     Result<> addFolder(Path const& path) {
@@ -695,7 +1018,7 @@ public:
         return Path();
     }
 
-    std::unordered_map<Path, ZipEntry, path_hash_t> getEntries() const {
+    std::unordered_map<Path, ZipEntry, path_hash_t> const& getEntries() const {
         return m_entries;
     }
 
@@ -729,6 +1052,11 @@ Result<Unzip> Unzip::create(ByteSpan data) {
     return Ok(Unzip(std::move(impl)));
 }
 
+Result<Unzip> Unzip::create(ByteVector&& data) {
+    GEODE_UNWRAP_INTO(auto impl, Zip::Impl::fromMemory(std::move(data)));
+    return Ok(Unzip(std::move(impl)));
+}
+
 Unzip::Path Unzip::getPath() const {
     return m_impl->getPath();
 }
@@ -747,6 +1075,20 @@ bool Unzip::hasEntry(Path const& name) {
     return m_impl->getEntries().count(name);
 }
 
+std::optional<Unzip::EntryInfo> Unzip::getEntryInfo(Path const& name) const {
+    auto& entries = m_impl->getEntries();
+    auto it = entries.find(name);
+    if (it == entries.end()) {
+        return std::nullopt;
+    }
+    return EntryInfo {
+        .isDirectory = it->second.isDirectory,
+        .crc32 = it->second.crc32,
+        .compressedSize = it->second.compressedSize,
+        .uncompressedSize = it->second.uncompressedSize,
+    };
+}
+
 Result<ByteVector> Unzip::extract(Path const& name) {
     return m_impl->extract(name).mapErr([&](auto error) {
         return fmt::format("Unable to extract entry {}: {}", name, error);
@@ -754,15 +1096,12 @@ Result<ByteVector> Unzip::extract(Path const& name) {
 }
 
 Result<> Unzip::extractTo(Path const& name, Path const& path) {
-    GEODE_UNWRAP_INTO(auto bytes, m_impl->extract(name).mapErr([&](auto error) {
-        return fmt::format("Unable to extract entry {}: {}", name, error);
-    }));
     // create containing directories for target path
     if (path.has_parent_path()) {
         GEODE_UNWRAP(file::createDirectoryAll(path.parent_path()));
     }
-    GEODE_UNWRAP(file::writeBinary(path, bytes).mapErr([&](auto error) {
-        return fmt::format("Unable to write file {}: {}", path, error);
+    GEODE_UNWRAP(m_impl->extractTo(name, path).mapErr([&](auto error) {
+        return fmt::format("Unable to extract entry {}: {}", name, error);
     }));
     return Ok();
 }
@@ -771,6 +1110,10 @@ Result<> Unzip::extractAllTo(Path const& dir) {
     return m_impl->extractAllTo(dir);
 }
 
+Result<> Unzip::extractAllTo(Path const& dir, geode::Function<bool(Path const&)> filter) {
+    return m_impl->extractAllTo(dir, std::move(filter));
+}
+
 Result<> Unzip::intoDir(
     Path const& from,
     Path const& to,
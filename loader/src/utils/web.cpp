@@ -1,10 +1,13 @@
+#include <Geode/loader/Dirs.hpp>
 #include <Geode/loader/Log.hpp>
 #include <Geode/Result.hpp>
 #include <Geode/utils/general.hpp>
 #include <filesystem>
 #include <fmt/format.h>
 #include <fstream>
+#include <hash/hash.hpp>
 #include <matjson.hpp>
+#include <mutex>
 #include <system_error>
 #define CURL_STATICLIB
 #include <Geode/loader/Mod.hpp>
@@ -196,6 +199,331 @@ Result<> WebResponse::Impl::into(std::filesystem::path const& path) const {
     return utils::file::writeBinary(path, m_data);
 }
 
+static constexpr uint64_t HTTP_CACHE_MAX_SIZE = 64 * 1024 * 1024;
+// anything bigger than this is better off downloaded again than taking up the cache
+static constexpr uint64_t HTTP_CACHE_MAX_ENTRY_SIZE = 8 * 1024 * 1024;
+// cap on heuristic freshness for responses that only have Last-Modified
+static constexpr int64_t HTTP_CACHE_MAX_HEURISTIC_AGE = 24 * 60 * 60;
+static constexpr int HTTP_CACHE_VERSION = 1;
+
+static std::optional<std::string_view> findHeader(
+    utils::StringMap<std::vector<std::string>> const& headers, std::string_view name
+) {
+    for (auto& [key, values] : headers) {
+        if (!values.empty() && equalsIgnoreCase(key, name)) {
+            // redirects add their own headers, the final response's come last
+            return values.back();
+        }
+    }
+    return std::nullopt;
+}
+
+static int64_t unixNow() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+}
+
+static std::optional<int64_t> parseHttpDate(std::optional<std::string_view> value) {
+    if (!value) return std::nullopt;
+    auto time = curl_getdate(std::string(*value).c_str(), nullptr);
+    if (time < 0) return std::nullopt;
+    return static_cast<int64_t>(time);
+}
+
+struct HttpCacheEntry {
+    int code = 0;
+    utils::StringMap<std::vector<std::string>> headers;
+    std::string file;
+    uint64_t size = 0;
+    int64_t expiresAt = 0;
+    int64_t lastUsed = 0;
+    std::string etag;
+    std::string lastModified;
+};
+
+// Private HTTP cache for requests that opt in with WebRequest::httpCache. Entries are
+// kept fresh for as long as Cache-Control / Expires allows, then revalidated with
+// their ETag or Last-Modified. Bodies are stored next to an index of all entries,
+// with the least recently used ones evicted once the cache gets too big.
+// --geode:geode.loader.http-cache-dir=<name> keeps it in another folder of the cache
+// directory, so tests don't fill up (or depend on) the real one
+class HttpCache final {
+private:
+    struct State {
+        utils::StringMap<HttpCacheEntry> entries;
+        uint64_t totalSize = 0;
+        bool dirty = false;
+    };
+
+    std::filesystem::path m_dir = dirs::getCacheDir() / Mod::get()->getLaunchArgument("http-cache-dir").value_or("web");
+    asp::Mutex<State> m_state;
+    std::mutex m_saveMutex;
+    std::atomic<bool> m_saveQueued = false;
+
+    // the index is loaded the first time the cache is used
+    HttpCache() {
+        this->load(*m_state.lock());
+    }
+
+public:
+    struct Hit {
+        HttpCacheEntry entry;
+        ByteVector body;
+        bool fresh;
+    };
+
+    static HttpCache& get() {
+        static HttpCache instance;
+        return instance;
+    }
+
+    // reads the body from disk, so this should be called on the blocking pool
+    std::optional<Hit> lookup(std::string const& url) {
+        std::string file;
+        {
+            auto state = m_state.lock();
+            auto it = state->entries.find(url);
+            if (it == state->entries.end()) {
+                return std::nullopt;
+            }
+            it->second.lastUsed = unixNow();
+            state->dirty = true;
+            file = it->second.file;
+        }
+        this->scheduleSave();
+
+        auto body = file::readBinary(m_dir / file);
+
+        auto state = m_state.lock();
+        auto it = state->entries.find(url);
+        if (!body || it == state->entries.end() || body.unwrap().size() != it->second.size) {
+            if (it != state->entries.end()) {
+                this->removeEntry(*state, it);
+                this->scheduleSave();
+            }
+            return std::nullopt;
+        }
+        return Hit {
+            .entry = it->second,
+            .body = std::move(body).unwrap(),
+            .fresh = it->second.expiresAt > unixNow(),
+        };
+    }
+
+    // stores a successful response, if its headers allow it
+    void store(std::string const& url, int code, utils::StringMap<std::vector<std::string>> const& headers, ByteVector const& body) {
+        if (body.size() > HTTP_CACHE_MAX_ENTRY_SIZE) {
+            return;
+        }
+        // entries are keyed by url alone, so responses that differ by request header can't be
+        // told apart. curl decodes the body whatever the Accept-Encoding was, so that one is fine
+        if (auto vary = findHeader(headers, "Vary")) {
+            for (auto name : asp::iter::split(*vary, ',')) {
+                auto trimmed = utils::string::trim(std::string(name));
+                if (!trimmed.empty() && !equalsIgnoreCase(trimmed, "Accept-Encoding")) {
+                    return;
+                }
+            }
+        }
+        auto expiresAt = freshUntil(headers);
+        if (!expiresAt) {
+            return;
+        }
+        auto etag = findHeader(headers, "ETag");
+        auto lastModified = findHeader(headers, "Last-Modified");
+        // something that can't be reused nor revalidated isn't worth keeping
+        if (*expiresAt <= unixNow() && !etag && !lastModified) {
+            return;
+        }
+
+        auto entry = HttpCacheEntry {
+            .code = code,
+            .headers = headers,
+            .file = calculateHash(url).substr(0, 32),
+            .size = body.size(),
+            .expiresAt = *expiresAt,
+            .lastUsed = unixNow(),
+            .etag = std::string(etag.value_or("")),
+            .lastModified = std::string(lastModified.value_or("")),
+        };
+
+        // the index only learns about the entry once its body is on disk
+        async::runtime().spawnBlocking<void>([this, url = url, entry = std::move(entry), body = body]() mutable {
+            std::error_code ec;
+            std::filesystem::create_directories(m_dir, ec);
+            if (!file::writeBinarySafe(m_dir / entry.file, body)) {
+                return;
+            }
+            {
+                auto state = m_state.lock();
+                auto it = state->entries.find(url);
+                if (it != state->entries.end()) {
+                    state->totalSize -= it->second.size;
+                }
+                state->totalSize += entry.size;
+                state->entries.insert_or_assign(std::move(url), std::move(entry));
+                this->evict(*state);
+            }
+            this->save();
+        });
+    }
+
+    // a 304 means the stored body is still good, and tells how long it stays fresh for
+    void refresh(std::string const& url, utils::StringMap<std::vector<std::string>> const& headers) {
+        {
+            auto state = m_state.lock();
+            auto it = state->entries.find(url);
+            if (it == state->entries.end()) {
+                return;
+            }
+            auto expiresAt = freshUntil(headers);
+            if (!expiresAt) {
+                this->removeEntry(*state, it);
+            }
+            else {
+                it->second.expiresAt = *expiresAt;
+                if (auto etag = findHeader(headers, "ETag")) {
+                    it->second.etag = *etag;
+                }
+                state->dirty = true;
+            }
+        }
+        this->scheduleSave();
+    }
+
+private:
+    // until when the response may be reused without revalidating it (RFC 9111),
+    // or nullopt if it must not be stored at all
+    static std::optional<int64_t> freshUntil(utils::StringMap<std::vector<std::string>> const& headers) {
+        auto now = unixNow();
+        std::optional<int64_t> maxAge;
+        for (auto directive : asp::iter::split(findHeader(headers, "Cache-Control").value_or(""), ',')) {
+            auto trimmed = utils::string::trim(std::string(directive));
+            auto value = std::string_view(trimmed);
+            if (equalsIgnoreCase(value, "no-store")) {
+                return std::nullopt;
+            }
+            if (equalsIgnoreCase(value, "no-cache")) {
+                maxAge = 0;
+            } else if (value.size() > 8 && equalsIgnoreCase(value.substr(0, 8), "max-age=") && !maxAge) {
+                maxAge = utils::numFromString<int64_t>(value.substr(8)).unwrapOr(0);
+            }
+        }
+
+        auto date = parseHttpDate(findHeader(headers, "Date")).value_or(now);
+        if (!maxAge) {
+            if (auto expires = findHeader(headers, "Expires")) {
+                // invalid dates (like "0") mean already expired
+                maxAge = parseHttpDate(expires).value_or(date) - date;
+            } else if (auto lastModified = parseHttpDate(findHeader(headers, "Last-Modified"))) {
+                maxAge = std::min((date - *lastModified) / 10, HTTP_CACHE_MAX_HEURISTIC_AGE);
+            } else {
+                maxAge = 0;
+            }
+        }
+        auto age = utils::numFromString<int64_t>(findHeader(headers, "Age").value_or("0")).unwrapOr(0);
+        return now + std::max<int64_t>(*maxAge - age, 0);
+    }
+
+    void removeEntry(State& state, utils::StringMap<HttpCacheEntry>::iterator it) {
+        std::error_code ec;
+        std::filesystem::remove(m_dir / it->second.file, ec);
+        state.totalSize -= it->second.size;
+        state.entries.erase(it);
+        state.dirty = true;
+    }
+
+    void evict(State& state) {
+        while (state.totalSize > HTTP_CACHE_MAX_SIZE && !state.entries.empty()) {
+            auto oldest = std::ranges::min_element(state.entries, {}, [](auto const& pair) {
+                return pair.second.lastUsed;
+            });
+            this->removeEntry(state, oldest);
+        }
+    }
+
+    void load(State& state) {
+        auto res = file::readJson(m_dir / "index.json");
+        if (!res) {
+            return;
+        }
+        auto json = std::move(res).unwrap();
+        if (json["version"].asInt().unwrapOr(0) != HTTP_CACHE_VERSION) {
+            return;
+        }
+        for (auto& [url, value] : json["entries"]) {
+            HttpCacheEntry entry {
+                .code = static_cast<int>(value["code"].asInt().unwrapOr(0)),
+                .file = value["file"].asString().unwrapOr(""),
+                .size = value["size"].asUInt().unwrapOr(0),
+                .expiresAt = value["expires-at"].asInt().unwrapOr(0),
+                .lastUsed = value["last-used"].asInt().unwrapOr(0),
+                .etag = value["etag"].asString().unwrapOr(""),
+                .lastModified = value["last-modified"].asString().unwrapOr(""),
+            };
+            for (auto& [name, values] : value["headers"]) {
+                auto& target = entry.headers[name];
+                for (auto& header : values) {
+                    target.push_back(header.asString().unwrapOr(""));
+                }
+            }
+            if (entry.file.empty()) continue;
+            state.totalSize += entry.size;
+            state.entries.insert_or_assign(url, std::move(entry));
+        }
+    }
+
+    // writes the index on the blocking pool, unless a write is already waiting to happen
+    void scheduleSave() {
+        if (m_saveQueued.exchange(true)) {
+            return;
+        }
+        async::runtime().spawnBlocking<void>([this] {
+            m_saveQueued.store(false);
+            this->save();
+        });
+    }
+
+    void save() {
+        std::lock_guard lock(m_saveMutex);
+
+        auto entries = matjson::Value::object();
+        {
+            auto state = m_state.lock();
+            if (!state->dirty) {
+                return;
+            }
+            state->dirty = false;
+            for (auto& [url, entry] : state->entries) {
+                auto headers = matjson::Value::object();
+                for (auto& [name, values] : entry.headers) {
+                    auto array = matjson::Value::array();
+                    for (auto& value : values) {
+                        array.push(value);
+                    }
+                    headers[name] = std::move(array);
+                }
+                entries[url] = matjson::makeObject({
+                    { "code", entry.code },
+                    { "file", entry.file },
+                    { "size", entry.size },
+                    { "expires-at", entry.expiresAt },
+                    { "last-used", entry.lastUsed },
+                    { "etag", entry.etag },
+                    { "last-modified", entry.lastModified },
+                    { "headers", std::move(headers) },
+                });
+            }
+        }
+
+        (void) file::writeStringSafe(m_dir / "index.json", matjson::makeObject({
+            { "version", HTTP_CACHE_VERSION },
+            { "entries", std::move(entries) },
+        }).dump(matjson::NO_INDENTATION));
+    }
+};
+
 struct MultipartFile {
     ByteVector data;
     std::string filename;
@@ -432,6 +760,12 @@ public:
         WebResponse response;
         geode::Function<void(WebResponse)> onComplete;
         CURL* curl = nullptr;
+        // the full url, if the request can use the http cache
+        std::string cacheKey;
+        // the cached response, which is being revalidated if it's stale
+        std::optional<HttpCache::Hit> cacheHit;
+        // the cache is looked up on the blocking pool before the request comes back to the worker
+        bool cacheChecked = false;
 
         RequestData(std::shared_ptr<WebRequest::Impl> req, Mod* mod, size_t id, geode::Function<void(WebResponse)> cb)
             : request(std::move(req)), mod(mod), id(id), onComplete(std::move(cb)) {}
@@ -491,6 +825,7 @@ public:
     std::optional<asp::Duration> m_timeout;
     std::optional<std::pair<std::uint64_t, std::uint64_t>> m_range;
     std::vector<geode::Function<void(WebProgress const&)>> m_progressCallbacks;
+    geode::Function<bool(ByteSpan)> m_dataCallback;
     std::string m_CABundleContent;
     std::optional<DnsServer> m_dnsServer;
     bool m_bypassDnsCache = false;
@@ -500,6 +835,7 @@ public:
     bool m_transferBody = true;
     bool m_followRedirects = true;
     bool m_ignoreContentLength = false;
+    bool m_httpCache = false;
     ProxyOpts m_proxyOpts = {};
     HttpVersion m_httpVersion = HttpVersion::DEFAULT;
     size_t m_id;
@@ -524,7 +860,28 @@ public:
 
         // ensure that progress callbacks are destroyed in the main thread,
         // because they may capture objects with non thread-safe destructors
-        geode::queueInMainThread([_ = std::move(m_progressCallbacks)] {});
+        geode::queueInMainThread([_ = std::move(m_progressCallbacks), __ = std::move(m_dataCallback)] {});
+    }
+
+    // only plain GETs whose body ends up in the response can be cached
+    bool canUseCache() const {
+        return m_httpCache && m_method == "GET" && m_transferBody && !m_body && !m_range && !m_dataCallback
+            && !findHeader(m_headers, "Authorization")
+            && !findHeader(m_headers, "Cache-Control").value_or("").contains("no-store");
+    }
+
+    std::string getFullUrl() const {
+        StringBuffer<> urlBuffer{m_url};
+        bool first = m_url.find('?') == std::string::npos;
+
+        for (auto& [key, value] : m_urlParameters) {
+            urlBuffer.append(first ? '?' : '&');
+            urlEncodeAppend(urlBuffer, key);
+            urlBuffer.append('=');
+            urlEncodeAppend(urlBuffer, value);
+            first = false;
+        }
+        return std::string(urlBuffer.view());
     }
 
     WebResponse makeError(GeodeWebError code, std::string_view msg) {
@@ -541,14 +898,24 @@ public:
             return nullptr;
         }
 
-        // todo: in the future, we might want to support downloading directly into
-        // files / in-memory streams like the old AsyncWebRequest class
-
-        // Store downloaded response data into a byte vector
+        // Store downloaded response data into a byte vector, or hand it
+        // straight to the data callback if there is one
         using ResponseData = WebRequestsManager::RequestData;
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, requestData);
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, +[](char* data, size_t size, size_t nmemb, void* ptr) {
             auto* rd = static_cast<ResponseData*>(ptr);
+
+            // error responses are still buffered, so their message can be read
+            if (auto& callback = rd->request->m_dataCallback) {
+                long code = 0;
+                curl_easy_getinfo(rd->curl, CURLINFO_RESPONSE_CODE, &code);
+                if (code >= 200 && code < 300) {
+                    auto chunk = ByteSpan(reinterpret_cast<uint8_t const*>(data), size * nmemb);
+                    // returning less than was given makes curl abort the transfer
+                    return callback(chunk) ? size * nmemb : 0;
+                }
+            }
+
             auto& target = rd->response.m_impl->m_data;
 
             // pre-allocate space to avoid reallocations
@@ -587,17 +954,7 @@ public:
         curl_easy_setopt(curl, CURLOPT_HTTPHEADER, m_curlHeaders);
 
         // Add parameters to the URL and pass it to curl
-        StringBuffer<> urlBuffer{m_url};
-        bool first = m_url.find('?') == std::string::npos;
-
-        for (auto& [key, value] : m_urlParameters) {
-            urlBuffer.append(first ? '?' : '&');
-            urlEncodeAppend(urlBuffer, key);
-            urlBuffer.append('=');
-            urlEncodeAppend(urlBuffer, value);
-            first = false;
-        }
-        curl_easy_setopt(curl, CURLOPT_URL, urlBuffer.c_str());
+        curl_easy_setopt(curl, CURLOPT_URL, this->getFullUrl().c_str());
 
         // Set HTTP version
         auto useHttp1 = Loader::get()->getLaunchFlag("use-http1");
@@ -1038,6 +1395,11 @@ WebRequest& WebRequest::ignoreContentLength(bool enabled) {
     return *this;
 }
 
+WebRequest& WebRequest::httpCache(bool enabled) {
+    m_impl->m_httpCache = enabled;
+    return *this;
+}
+
 WebRequest& WebRequest::CABundleContent(std::string content) {
     m_impl->m_CABundleContent = std::move(content);
     return *this;
@@ -1083,6 +1445,11 @@ WebRequest& WebRequest::onProgress(Function<void(WebProgress const&)> callback)
     return *this;
 }
 
+WebRequest& WebRequest::onData(Function<bool(ByteSpan)> callback) {
+    m_impl->m_dataCallback = std::move(callback);
+    return *this;
+}
+
 size_t WebRequest::getID() const {
     return m_impl->m_id;
 }
@@ -1282,6 +1649,20 @@ public:
     }
 
     void workerAddRequest(std::shared_ptr<RequestData> req) {
+        // it may have been cancelled while the cache was being looked up
+        if (req->request->m_cancelled.load(std::memory_order::relaxed)) {
+            return;
+        }
+        if (req->request->canUseCache()) {
+            if (!req->cacheChecked) {
+                this->workerLookupCache(std::move(req));
+                return;
+            }
+            if (this->workerTryCache(*req)) {
+                return;
+            }
+        }
+
         CURL* handle = req->request->makeCurlHandle(req.get());
 
         if (!handle) {
@@ -1301,6 +1682,79 @@ public:
         this->workerKickCurl();
     }
 
+    // reading a cached body can take a while, so it happens on the blocking pool and the
+    // request is queued again once it's done
+    void workerLookupCache(std::shared_ptr<RequestData> req) {
+        req->cacheChecked = true;
+        req->cacheKey = req->request->getFullUrl();
+        async::runtime().spawnBlocking<void>([this, req = std::move(req)] {
+            req->cacheHit = HttpCache::get().lookup(req->cacheKey);
+            if (!m_reqtx->trySend(req)) {
+                req->onError(GeodeWebError::QUEUE_FULL, "Failed to enqueue web request: queue is full");
+            }
+        });
+    }
+
+    // answers the request from the http cache if it has a fresh response, otherwise
+    // asks the server whether the stale one can be reused
+    bool workerTryCache(RequestData& req) {
+        auto& request = *req.request;
+        auto hit = std::exchange(req.cacheHit, std::nullopt);
+        if (!hit) {
+            return false;
+        }
+
+        auto revalidate = findHeader(request.m_headers, "Cache-Control").value_or("").contains("no-cache");
+        if (hit->fresh && !revalidate) {
+            if (verboseLog()) {
+                log::debug("Serving request from cache ({})", req.cacheKey);
+            }
+            auto& response = *req.response.m_impl;
+            response.m_code = hit->entry.code;
+            response.m_headers = std::move(hit->entry.headers);
+            response.m_data = std::move(hit->body);
+            req.complete(std::move(req.response));
+            return true;
+        }
+
+        // leave conditional requests made by the caller alone
+        if (findHeader(request.m_headers, "If-None-Match") || findHeader(request.m_headers, "If-Modified-Since")) {
+            return false;
+        }
+        if (!hit->entry.etag.empty()) {
+            request.m_headers.insert_or_assign("If-None-Match", std::vector{hit->entry.etag});
+        } else if (!hit->entry.lastModified.empty()) {
+            request.m_headers.insert_or_assign("If-Modified-Since", std::vector{hit->entry.lastModified});
+        } else {
+            return false;
+        }
+        req.cacheHit = std::move(hit);
+        return false;
+    }
+
+    void workerUpdateCache(RequestData& req) {
+        if (req.cacheKey.empty()) {
+            return;
+        }
+
+        auto& response = *req.response.m_impl;
+        if (req.cacheHit && response.m_code == 304) {
+            HttpCache::get().refresh(req.cacheKey, response.m_headers);
+
+            // the 304's headers are newer than the stored ones
+            auto headers = std::move(req.cacheHit->entry.headers);
+            for (auto& [name, values] : response.m_headers) {
+                headers.insert_or_assign(name, std::move(values));
+            }
+            response.m_code = req.cacheHit->entry.code;
+            response.m_headers = std::move(headers);
+            response.m_data = std::move(req.cacheHit->body);
+            req.cacheHit.reset();
+        } else if (response.m_code == 200) {
+            HttpCache::get().store(req.cacheKey, response.m_code, response.m_headers, response.m_data);
+        }
+    }
+
     void workerCancelRequest(std::shared_ptr<RequestData> req) {
         if (verboseLog()) {
             log::debug("Cancelled request ({})", req->request->m_url);
@@ -1399,6 +1853,8 @@ public:
                             : fmt::format("Curl failed: {} ({})", err, errorBuf)
                     );
                 } else {
+                    this->workerUpdateCache(requestData);
+
                     // resolve with success :-)
                     requestData.complete(std::move(requestData.response));
                 }
@@ -1677,6 +2133,460 @@ mpsc::SendResult<std::shared_ptr<WebRequestsManager::RequestData>> WebRequestsMa
     return m_impl->m_reqtx->trySend(std::move(data));
 }
 
+static constexpr size_t FILE_DOWNLOAD_DEFAULT_SEGMENTS = 4;
+// segments smaller than this aren't worth a request of their own
+static constexpr uint64_t FILE_DOWNLOAD_MIN_SEGMENT_SIZE = 1024 * 1024;
+// how much may be downloaded between saves of the state file
+static constexpr uint64_t FILE_DOWNLOAD_SAVE_INTERVAL = 512 * 1024;
+static constexpr size_t FILE_DOWNLOAD_MAX_ATTEMPTS = 3;
+static constexpr int FILE_DOWNLOAD_STATE_VERSION = 1;
+
+// headers are kept as they were received, and redirects add their own
+static std::optional<std::string> lastHeader(WebResponse const& response, std::string_view name) {
+    for (auto& key : response.headers()) {
+        if (!utils::string::equalsIgnoreCase(key, name)) continue;
+        if (auto values = response.getAllHeadersNamed(key); values && !values->empty()) {
+            return values->back();
+        }
+    }
+    return std::nullopt;
+}
+
+static std::string describeDownloadError(WebResponse const& response) {
+    if (response.code() <= 0) {
+        auto message = response.errorMessage();
+        return fmt::format(
+            "Request failed: {}",
+            message.empty() ? response.string().unwrapOr("No message") : std::string(message)
+        );
+    }
+    return fmt::format("Server returned error {}: {}", response.code(), response.string().unwrapOr("No message"));
+}
+
+namespace {
+    struct DownloadSegment {
+        uint64_t begin;
+        // exclusive, or UINT64_MAX if the size isn't known
+        uint64_t end;
+        uint64_t done = 0;
+
+        uint64_t remaining() const {
+            return end - begin - done;
+        }
+    };
+
+    struct DownloadFileData {
+        std::fstream file;
+        std::vector<DownloadSegment> segments;
+        uint64_t unsavedBytes = 0;
+        std::string error;
+    };
+
+    // the target file of a FileDownload, written to by the segment requests
+    // on the networking thread
+    class DownloadFile final {
+    public:
+        DownloadFile(std::filesystem::path path, std::string url)
+          : m_path(std::move(path)), m_url(std::move(url))
+        {
+            m_statePath = m_path;
+            m_statePath += ".state";
+        }
+
+        // picks up a previous attempt if it was downloading the same thing
+        Result<> resume(uint64_t size, std::string validator) {
+            m_size = size;
+            m_validator = std::move(validator);
+
+            auto json = GEODE_UNWRAP(file::readJson(m_statePath));
+            if (json["version"].asInt().unwrapOr(0) != FILE_DOWNLOAD_STATE_VERSION) {
+                return Err("Unsupported state file version");
+            }
+            if (json["url"].asString().unwrapOr("") != m_url) {
+                return Err("URL has changed");
+            }
+            if (json["size"].asUInt().unwrapOr(0) != m_size || json["validator"].asString().unwrapOr("") != m_validator) {
+                return Err("File has changed on the server");
+            }
+            std::error_code ec;
+            if (std::filesystem::file_size(m_path, ec) != m_size || ec) {
+                return Err("Partially downloaded file is missing");
+            }
+
+            std::vector<DownloadSegment> segments;
+            for (auto& value : GEODE_UNWRAP(json["segments"].asArray())) {
+                auto segment = DownloadSegment {
+                    .begin = GEODE_UNWRAP(value["begin"].asUInt()),
+                    .end = GEODE_UNWRAP(value["end"].asUInt()),
+                    .done = GEODE_UNWRAP(value["done"].asUInt()),
+                };
+                if (segment.begin > segment.end || segment.end > m_size || segment.done > segment.end - segment.begin) {
+                    return Err("Invalid segment");
+                }
+                segments.push_back(segment);
+            }
+
+            auto data = m_data.lock();
+            data->file.open(m_path, std::ios::in | std::ios::out | std::ios::binary);
+            if (!data->file) {
+                return Err("Unable to open {}", m_path);
+            }
+            data->segments = std::move(segments);
+            return Ok();
+        }
+
+        // starts over, splitting the file into the given number of segments
+        Result<> start(uint64_t size, std::string validator, size_t segmentCount) {
+            m_size = size;
+            m_validator = std::move(validator);
+
+            auto data = m_data.lock();
+            data->file.close();
+            data->file.open(m_path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!data->file) {
+                return Err("Unable to open {} for writing", m_path);
+            }
+            // filesystems that support it keep the unwritten parts sparse
+            std::error_code ec;
+            std::filesystem::resize_file(m_path, m_size, ec);
+            if (ec) {
+                return Err("Unable to allocate {} bytes for {} (code {})", m_size, m_path, ec);
+            }
+
+            data->segments.clear();
+            auto segmentSize = m_size / segmentCount;
+            for (size_t i = 0; i < segmentCount; i++) {
+                auto begin = i * segmentSize;
+                data->segments.push_back(DownloadSegment {
+                    .begin = begin,
+                    .end = i + 1 == segmentCount ? m_size : begin + segmentSize,
+                });
+            }
+            this->saveState(*data);
+            return Ok();
+        }
+
+        // for servers without range support, where the file can only be downloaded
+        // in one go and there's nothing to resume
+        Result<> startWhole() {
+            m_size = 0;
+            std::error_code ec;
+            std::filesystem::remove(m_statePath, ec);
+
+            auto data = m_data.lock();
+            data->file.close();
+            data->file.open(m_path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!data->file) {
+                return Err("Unable to open {} for writing", m_path);
+            }
+            data->segments = { DownloadSegment { .begin = 0, .end = UINT64_MAX } };
+            return Ok();
+        }
+
+        bool isResumable() const {
+            return m_size > 0;
+        }
+
+        // the byte ranges that are still missing, by segment index
+        std::vector<std::pair<size_t, std::pair<uint64_t, uint64_t>>> pendingRanges() {
+            std::vector<std::pair<size_t, std::pair<uint64_t, uint64_t>>> ret;
+            auto data = m_data.lock();
+            for (size_t i = 0; i < data->segments.size(); i++) {
+                auto& segment = data->segments[i];
+                if (segment.remaining() == 0) continue;
+                // a download without ranges can only start over
+                if (!this->isResumable()) {
+                    segment.done = 0;
+                }
+                ret.push_back({ i, { segment.begin + segment.done, segment.end - 1 } });
+            }
+            return ret;
+        }
+
+        // called on the networking thread
+        bool write(size_t index, ByteSpan bytes, Function<Result<>(uint64_t, ByteSpan)>& callback) {
+            auto data = m_data.lock();
+            if (!data->error.empty()) {
+                return false;
+            }
+            auto& segment = data->segments[index];
+            if (bytes.size() > segment.remaining()) {
+                data->error = "Server sent more data than was requested";
+                return false;
+            }
+            if (callback) {
+                if (auto res = callback(segment.begin + segment.done, bytes); !res) {
+                    data->error = std::move(res).unwrapErr();
+                    return false;
+                }
+            }
+            data->file.seekp(segment.begin + segment.done);
+            data->file.write(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+            if (!data->file) {
+                data->error = fmt::format("Unable to write to {}", m_path);
+                return false;
+            }
+            segment.done += bytes.size();
+            data->unsavedBytes += bytes.size();
+            if (data->unsavedBytes >= FILE_DOWNLOAD_SAVE_INTERVAL) {
+                this->saveState(*data);
+            }
+            return true;
+        }
+
+        // marks a download without ranges as complete once its request succeeds
+        void finishWhole() {
+            auto data = m_data.lock();
+            auto& segment = data->segments.front();
+            segment.end = segment.begin + segment.done;
+        }
+
+        std::optional<std::string> takeError() {
+            auto data = m_data.lock();
+            if (data->error.empty()) {
+                return std::nullopt;
+            }
+            return std::exchange(data->error, {});
+        }
+
+        bool isComplete() {
+            auto data = m_data.lock();
+            return std::all_of(data->segments.begin(), data->segments.end(), [](auto const& segment) {
+                return segment.remaining() == 0;
+            });
+        }
+
+        uint64_t downloaded() {
+            uint64_t ret = 0;
+            auto data = m_data.lock();
+            for (auto& segment : data->segments) {
+                ret += segment.done;
+            }
+            return ret;
+        }
+
+        uint64_t size() const {
+            return m_size;
+        }
+
+        // keeps whatever was downloaded so far for the next attempt
+        void suspend() {
+            auto data = m_data.lock();
+            this->saveState(*data);
+            data->file.close();
+        }
+
+        Result<> finish() {
+            auto data = m_data.lock();
+            data->file.close();
+            if (data->file.fail()) {
+                return Err("Unable to write to {}", m_path);
+            }
+            std::error_code ec;
+            std::filesystem::remove(m_statePath, ec);
+            return Ok();
+        }
+
+    private:
+        std::filesystem::path m_path;
+        std::filesystem::path m_statePath;
+        std::string m_url;
+        // 0 if the server doesn't support ranges
+        uint64_t m_size = 0;
+        // etag or last-modified, whichever the server sent
+        std::string m_validator;
+        asp::Mutex<DownloadFileData> m_data;
+
+        void saveState(DownloadFileData& data) {
+            data.unsavedBytes = 0;
+            if (!this->isResumable()) return;
+
+            // the data has to hit the disk before the state claims it's there
+            data.file.flush();
+
+            auto segments = matjson::Value::array();
+            for (auto& segment : data.segments) {
+                segments.push(matjson::makeObject({
+                    { "begin", segment.begin },
+                    { "end", segment.end },
+                    { "done", segment.done },
+                }));
+            }
+            (void) file::writeStringSafe(m_statePath, matjson::makeObject({
+                { "version", FILE_DOWNLOAD_STATE_VERSION },
+                { "url", m_url },
+                { "size", m_size },
+                { "validator", m_validator },
+                { "segments", std::move(segments) },
+            }).dump(matjson::NO_INDENTATION));
+        }
+    };
+}
+
+class FileDownload::Impl final {
+public:
+    std::optional<std::string> m_userAgent;
+    std::vector<std::pair<std::string, std::string>> m_headers;
+    std::optional<std::chrono::seconds> m_timeout;
+    size_t m_segments = FILE_DOWNLOAD_DEFAULT_SEGMENTS;
+    Function<void(WebProgress const&)> m_progressCallback;
+    Function<Result<>(uint64_t, ByteSpan)> m_dataCallback;
+
+    WebRequest makeRequest() const {
+        WebRequest req;
+        if (m_userAgent) {
+            req.userAgent(*m_userAgent);
+        }
+        for (auto& [name, value] : m_headers) {
+            req.header(name, value);
+        }
+        if (m_timeout) {
+            req.timeout(*m_timeout);
+        }
+        // ranges of a compressed response don't line up with the file
+        req.acceptEncoding("identity");
+        return req;
+    }
+
+    static arc::Future<Result<>> run(std::shared_ptr<Impl> self, std::string url, std::filesystem::path path, Mod* mod);
+};
+
+arc::Future<Result<>> FileDownload::Impl::run(std::shared_ptr<Impl> self, std::string url, std::filesystem::path path, Mod* mod) {
+    auto file = std::make_shared<DownloadFile>(path, url);
+
+    // find out whether the file can be downloaded in parts by asking for its first byte.
+    // a server that supports ranges answers with 206 and the full size in Content-Range.
+    // some advertise Accept-Ranges and then send the whole file anyway, which is cut off
+    // right away, since writing it into segments would only corrupt the file
+    auto probed = std::make_shared<std::atomic<uint64_t>>(0);
+    auto probe = self->makeRequest();
+    probe.downloadRange({ 0, 0 });
+    probe.onData([probed](ByteSpan data) {
+        return (*probed += data.size()) <= 1;
+    });
+    // cutting off a server that ignores the range isn't worth an error in the log
+    probe.m_impl->m_silentFailure = true;
+    auto head = co_await probe.get(url, mod);
+    auto size = head.code() == 206 && *probed == 1
+        ? lastHeader(head, "Content-Range").and_then([](std::string const& value) {
+            auto slash = value.rfind('/');
+            return slash != std::string::npos
+                ? utils::numFromString<uint64_t>(value.substr(slash + 1)).ok()
+                : std::nullopt;
+        })
+        : std::nullopt;
+
+    if (size && *size > 0) {
+        auto validator = lastHeader(head, "ETag").or_else([&] {
+            return lastHeader(head, "Last-Modified");
+        }).value_or("");
+
+        if (auto res = file->resume(*size, validator); res) {
+            log::debug("Resuming download of {} to {}", url, path);
+        } else {
+            auto segments = std::clamp<uint64_t>(*size / FILE_DOWNLOAD_MIN_SEGMENT_SIZE, 1, std::max<size_t>(self->m_segments, 1));
+            if (auto started = file->start(*size, std::move(validator), segments); !started) {
+                co_return std::move(started);
+            }
+        }
+    } else if (auto res = file->startWhole(); !res) {
+        co_return std::move(res);
+    }
+
+    std::string lastError;
+    for (size_t attempt = 0; attempt < FILE_DOWNLOAD_MAX_ATTEMPTS; attempt++) {
+        auto pending = file->pendingRanges();
+        if (pending.empty()) break;
+        if (attempt > 0) {
+            log::debug("Retrying {} part(s) of {} ({})", pending.size(), url, lastError);
+        }
+
+        std::vector<WebFuture> requests;
+        requests.reserve(pending.size());
+        for (auto& [index, range] : pending) {
+            auto req = self->makeRequest();
+            if (file->isResumable()) {
+                req.downloadRange(range);
+            }
+            req.onData([self, file, index = index](ByteSpan data) {
+                return file->write(index, data, self->m_dataCallback);
+            });
+            if (self->m_progressCallback) {
+                req.onProgress([self, file](WebProgress const& progress) {
+                    // without ranges there's only one request, so its progress is all there is
+                    if (!file->isResumable()) {
+                        self->m_progressCallback(progress);
+                        return;
+                    }
+                    WebProgress total;
+                    total.m_downloadCurrent = file->downloaded();
+                    total.m_downloadTotal = file->size();
+                    self->m_progressCallback(total);
+                });
+            }
+            requests.push_back(req.get(url, mod));
+        }
+
+        auto responses = co_await arc::joinAll(std::move(requests));
+
+        // errors writing the file won't go away by trying again
+        if (auto error = file->takeError()) {
+            lastError = std::move(*error);
+            break;
+        }
+        for (auto& response : responses) {
+            if (!response.ok()) {
+                lastError = describeDownloadError(response);
+            } else if (!file->isResumable()) {
+                file->finishWhole();
+            }
+        }
+    }
+
+    if (!file->isComplete()) {
+        file->suspend();
+        co_return Err(lastError.empty() ? "Download did not complete" : lastError);
+    }
+    co_return file->finish();
+}
+
+FileDownload::FileDownload() : m_impl(std::make_shared<Impl>()) {}
+FileDownload::~FileDownload() = default;
+
+FileDownload& FileDownload::userAgent(std::string name) {
+    m_impl->m_userAgent = std::move(name);
+    return *this;
+}
+
+FileDownload& FileDownload::header(std::string name, std::string value) {
+    m_impl->m_headers.emplace_back(std::move(name), std::move(value));
+    return *this;
+}
+
+FileDownload& FileDownload::timeout(std::chrono::seconds time) {
+    m_impl->m_timeout = time;
+    return *this;
+}
+
+FileDownload& FileDownload::segments(size_t count) {
+    m_impl->m_segments = count;
+    return *this;
+}
+
+FileDownload& FileDownload::onProgress(Function<void(WebProgress const&)> callback) {
+    m_impl->m_progressCallback = std::move(callback);
+    return *this;
+}
+
+FileDownload& FileDownload::onData(Function<Result<>(uint64_t offset, ByteSpan data)> callback) {
+    m_impl->m_dataCallback = std::move(callback);
+    return *this;
+}
+
+arc::Future<Result<>> FileDownload::download(std::string url, std::filesystem::path path, Mod* mod) {
+    return Impl::run(m_impl, std::move(url), std::move(path), mod);
+}
+
 static std::optional<DnsServer> serverForString(std::string_view which) {
     if (which == "Cloudflare") {
         return DnsServer {
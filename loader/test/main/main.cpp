@@ -1,6 +1,7 @@
 #include <Geode/Loader.hpp>
 #include <Geode/loader/ModEvent.hpp>
 #include <Geode/utils/cocos.hpp>
+#include <atomic>
 #include <chrono>
 #include "../dependency/main.hpp"
 #include "Geode/utils/general.hpp"
@@ -71,6 +72,80 @@ $on_mod(Loaded) {
     }).leak();
 }
 
+// Thread local events
+$on_mod(Loaded) {
+    int received = 0;
+    auto handle = TestEvent().listen([&](std::string_view) {
+        received++;
+    });
+
+    std::thread([] {
+        TestEvent().send("from another thread");
+    }).join();
+    log::info("Thread local event stayed on its own thread: {}", received == 0);
+
+    std::thread([handle = std::move(handle)] mutable {
+        handle.destroy();
+    }).join();
+    TestEvent().send("after handover");
+    log::info("Listener removed from other thread: {}", received == 0);
+}
+
+// Thread safe events
+struct StressEvent : ThreadSafeEvent<StressEvent, bool(int)> {
+    using ThreadSafeEvent::ThreadSafeEvent;
+};
+
+// Hammers one global port from several threads, which is mostly useful under
+// ThreadSanitizer. To run it, build the loader and this mod with
+// CMAKE_CXX_FLAGS="-fsanitize=thread -g" and CMAKE_EXE_LINKER_FLAGS / CMAKE_SHARED_LINKER_FLAGS
+// set to "-fsanitize=thread", then launch with --geode:geode.test.event-stress
+static void runEventStressTest() {
+    constexpr int SENDERS = 4;
+    constexpr int WRITERS = 2;
+    constexpr int SENDS = 2000;
+
+    std::atomic<int> received = 0;
+    auto handle = StressEvent().listen([&](int) {
+        received++;
+        return ListenerResult::Propagate;
+    });
+
+    std::atomic<bool> done = false;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < WRITERS; ++i) {
+        threads.emplace_back([&] {
+            while (!done) {
+                auto temp = StressEvent().listen([](int) {
+                    return ListenerResult::Propagate;
+                });
+                temp.destroy();
+            }
+        });
+    }
+    std::vector<std::thread> senders;
+    for (int i = 0; i < SENDERS; ++i) {
+        senders.emplace_back([] {
+            for (int j = 0; j < SENDS; ++j) {
+                StressEvent().send(j);
+            }
+        });
+    }
+    for (auto& t : senders) t.join();
+    done = true;
+    for (auto& t : threads) t.join();
+
+    log::info("Concurrent global sends all delivered: {}", received == SENDERS * SENDS);
+}
+
+$on_mod(Loaded) {
+    if (!Mod::get()->getLaunchFlag("event-stress")) {
+        return;
+    }
+    // keeps the load itself from waiting on it
+    std::thread(runEventStressTest).detach();
+}
+
 // Coroutines
 #include <Geode/utils/coro.hpp>
 auto advanceFrame() {
@@ -0,0 +1,521 @@
+// Sockets have to come before any Geode header, since those pull in Windows.h
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #pragma comment(lib, "ws2_32.lib")
+#else
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+#include <Geode/Loader.hpp>
+#include <Geode/utils/async.hpp>
+#include <Geode/utils/file.hpp>
+#include <Geode/utils/web.hpp>
+#include <arc/future/Join.hpp>
+#include <arc/time/Sleep.hpp>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+using namespace geode::prelude;
+
+#ifdef _WIN32
+using Socket = SOCKET;
+#else
+using Socket = int;
+static constexpr Socket INVALID_SOCKET = -1;
+static void closesocket(Socket socket) {
+    close(socket);
+}
+#endif
+
+#ifdef MSG_NOSIGNAL
+static constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static constexpr int SEND_FLAGS = 0;
+#endif
+
+// What the mock server answers with for a path
+struct MockRoute {
+    int status = 200;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+    std::chrono::milliseconds latency { 0 };
+    // sends the body in a few chunks with chunked transfer encoding
+    bool chunked = false;
+    // answers Range requests with 206 and the requested slice of the body
+    bool ranges = false;
+    // answers with the body of the request instead
+    bool echo = false;
+    // closes the connection after sending this much of the body, like a dropped download
+    size_t cutAfter = 0;
+};
+
+// A tiny HTTP/1.1 server on loopback that answers scripted routes, one
+// connection per request, so the web utils can be tested without the index
+class MockServer final {
+private:
+    Socket m_listener = INVALID_SOCKET;
+    uint16_t m_port = 0;
+    std::atomic_bool m_running = false;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::unordered_map<std::string, MockRoute> m_routes;
+    std::unordered_map<std::string, size_t> m_hits;
+    std::unordered_map<std::string, size_t> m_served;
+    std::vector<std::thread> m_connections;
+
+    static void sendAll(Socket client, std::string_view data) {
+        while (!data.empty()) {
+            auto sent = ::send(client, data.data(), static_cast<int>(data.size()), SEND_FLAGS);
+            if (sent <= 0) return;
+            data.remove_prefix(sent);
+        }
+    }
+
+    void acceptLoop() {
+        while (m_running) {
+            auto client = ::accept(m_listener, nullptr, nullptr);
+            if (client == INVALID_SOCKET) {
+                // stop() closing the socket ends the loop, anything else is worth a short break
+                if (m_running) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+                continue;
+            }
+            std::lock_guard lock(m_mutex);
+            m_connections.emplace_back([this, client] {
+                this->handle(client);
+                closesocket(client);
+            });
+        }
+    }
+
+    void handle(Socket client) {
+        std::string data;
+        char buf[4096];
+        size_t headerEnd;
+        while ((headerEnd = data.find("\r\n\r\n")) == std::string::npos) {
+            auto received = ::recv(client, buf, sizeof(buf), 0);
+            if (received <= 0) return;
+            data.append(buf, received);
+        }
+
+        std::string method, path;
+        std::optional<std::pair<size_t, std::optional<size_t>>> range;
+        std::string ifNoneMatch;
+        size_t contentLength = 0;
+
+        auto lines = string::split(std::string_view(data).substr(0, headerEnd), "\r\n");
+        if (lines.empty()) return;
+        auto requestLine = string::split(lines[0], " ");
+        if (requestLine.size() < 2) return;
+        method = requestLine[0];
+        path = requestLine[1].substr(0, requestLine[1].find('?'));
+
+        for (size_t i = 1; i < lines.size(); i++) {
+            auto colon = lines[i].find(':');
+            if (colon == std::string::npos) continue;
+            auto name = string::toLower(lines[i].substr(0, colon));
+            auto value = string::trim(lines[i].substr(colon + 1));
+            if (name == "content-length") {
+                contentLength = utils::numFromString<size_t>(value).unwrapOr(0);
+            }
+            else if (name == "range" && value.starts_with("bytes=")) {
+                auto bounds = string::split(value.substr(6), "-");
+                if (bounds.size() == 2) {
+                    auto start = utils::numFromString<size_t>(bounds[0]).unwrapOr(0);
+                    range.emplace(start, utils::numFromString<size_t>(bounds[1]).ok());
+                }
+            }
+            else if (name == "if-none-match") {
+                ifNoneMatch = value;
+            }
+        }
+
+        while (data.size() < headerEnd + 4 + contentLength) {
+            auto received = ::recv(client, buf, sizeof(buf), 0);
+            if (received <= 0) return;
+            data.append(buf, received);
+        }
+        auto requestBody = data.substr(headerEnd + 4, contentLength);
+
+        std::unique_lock lock(m_mutex);
+        auto it = m_routes.find(path);
+        if (it == m_routes.end()) {
+            lock.unlock();
+            sendAll(client, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+            return;
+        }
+        auto route = it->second;
+        m_hits[path] += 1;
+        lock.unlock();
+
+        std::this_thread::sleep_for(route.latency);
+
+        auto status = route.status;
+        auto body = route.echo ? std::move(requestBody) : route.body;
+        auto head = std::string();
+        for (auto& [name, value] : route.headers) {
+            head += fmt::format("{}: {}\r\n", name, value);
+            if (string::toLower(name) == "etag" && value == ifNoneMatch) {
+                status = 304;
+                body.clear();
+            }
+        }
+        if (route.ranges) {
+            head += "Accept-Ranges: bytes\r\n";
+            if (range && range->first < body.size()) {
+                auto last = std::min(range->second.value_or(body.size() - 1), body.size() - 1);
+                head += fmt::format("Content-Range: bytes {}-{}/{}\r\n", range->first, last, body.size());
+                body = body.substr(range->first, last - range->first + 1);
+                status = 206;
+            }
+        }
+
+        auto response = fmt::format("HTTP/1.1 {} Mock\r\nConnection: close\r\n{}", status, head);
+        if (route.chunked) {
+            response += "Transfer-Encoding: chunked\r\n\r\n";
+            if (method != "HEAD") {
+                auto chunkSize = std::max<size_t>(body.size() / 3, 1);
+                for (size_t i = 0; i < body.size(); i += chunkSize) {
+                    auto chunk = std::string_view(body).substr(i, chunkSize);
+                    response += fmt::format("{:x}\r\n{}\r\n", chunk.size(), chunk);
+                }
+                response += "0\r\n\r\n";
+            }
+        }
+        else {
+            response += fmt::format("Content-Length: {}\r\n\r\n", body.size());
+            if (method != "HEAD") {
+                if (route.cutAfter) {
+                    body.resize(std::min(body.size(), route.cutAfter));
+                }
+                response += body;
+            }
+        }
+        if (method != "HEAD") {
+            std::lock_guard lock(m_mutex);
+            m_served[path] += body.size();
+        }
+        sendAll(client, response);
+    }
+
+public:
+    MockServer() = default;
+    MockServer(MockServer const&) = delete;
+    MockServer& operator=(MockServer const&) = delete;
+
+    ~MockServer() {
+        this->stop();
+    }
+
+    void route(std::string path, MockRoute route) {
+        std::lock_guard lock(m_mutex);
+        m_routes[std::move(path)] = std::move(route);
+    }
+
+    size_t hits(std::string const& path) {
+        std::lock_guard lock(m_mutex);
+        auto it = m_hits.find(path);
+        return it != m_hits.end() ? it->second : 0;
+    }
+
+    // how many body bytes were sent for a path
+    size_t served(std::string const& path) {
+        std::lock_guard lock(m_mutex);
+        auto it = m_served.find(path);
+        return it != m_served.end() ? it->second : 0;
+    }
+
+    std::string url(std::string_view path) const {
+        return fmt::format("http://127.0.0.1:{}{}", m_port, path);
+    }
+
+    Result<> start() {
+    #ifdef _WIN32
+        WSADATA wsa;
+        if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
+            return Err("WSAStartup failed");
+        }
+    #endif
+        m_listener = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (m_listener == INVALID_SOCKET) {
+            return Err("Unable to create socket");
+        }
+
+        sockaddr_in addr {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        // let the system pick a free port
+        addr.sin_port = 0;
+        socklen_t addrLen = sizeof(addr);
+        if (
+            ::bind(m_listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            ::listen(m_listener, 128) != 0 ||
+            ::getsockname(m_listener, reinterpret_cast<sockaddr*>(&addr), &addrLen) != 0
+        ) {
+            closesocket(m_listener);
+            m_listener = INVALID_SOCKET;
+            return Err("Unable to listen on loopback");
+        }
+        m_port = ntohs(addr.sin_port);
+
+        m_running = true;
+        m_thread = std::thread([this] { this->acceptLoop(); });
+        return Ok();
+    }
+
+    void stop() {
+        if (!m_running.exchange(false)) return;
+        // unblocks the accept call
+        ::shutdown(m_listener, 2);
+        closesocket(m_listener);
+        m_thread.join();
+
+        std::vector<std::thread> connections;
+        {
+            std::lock_guard lock(m_mutex);
+            connections = std::move(m_connections);
+        }
+        for (auto& connection : connections) {
+            connection.join();
+        }
+    }
+};
+
+static std::string makeTestBody(size_t size) {
+    std::string body(size, '\0');
+    uint32_t state = 0x12345678;
+    for (auto& c : body) {
+        // xorshift, just so the content isn't uniform
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        c = static_cast<char>(state);
+    }
+    return body;
+}
+
+static double millisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// the cache tests write tens of megabytes and depend on what's in the cache, so
+// they only run against a folder of their own, given with
+// --geode:geode.loader.http-cache-dir=<name>
+static std::optional<std::filesystem::path> testCacheIndex() {
+    auto name = Loader::get()->getLaunchArgument("geode.loader.http-cache-dir");
+    if (!name) return std::nullopt;
+    return dirs::getCacheDir() / *name / "index.json";
+}
+
+// the cache index only learns about an entry once its body has been written
+static arc::Future<bool> waitUntilCached(std::filesystem::path const& index, std::string const& url) {
+    for (int i = 0; i < 250; i++) {
+        if (auto json = file::readJson(index); json && json.unwrap()["entries"].contains(url)) {
+            co_return true;
+        }
+        co_await arc::sleep(asp::Duration::fromMillis(20));
+    }
+    co_return false;
+}
+
+static size_t countCached(std::filesystem::path const& index, std::string_view prefix) {
+    auto json = file::readJson(index);
+    if (!json) return 0;
+    size_t count = 0;
+    for (auto& [url, _] : json.unwrap()["entries"]) {
+        count += url.starts_with(prefix);
+    }
+    return count;
+}
+
+static arc::Future<> runWebTests(std::shared_ptr<MockServer> server, std::string largeBody) {
+    // Regressions
+    auto hello = co_await web::WebRequest().get(server->url("/hello"));
+    log::info("Mock GET returned the body: {}", hello.ok() && hello.string().unwrapOr("") == "hello");
+
+    auto missing = co_await web::WebRequest().get(server->url("/missing"));
+    log::info("Mock unknown route returned 404: {}", missing.code() == 404);
+
+    auto error = co_await web::WebRequest().get(server->url("/error"));
+    log::info("Mock server error is reported: {}", error.badServer() && error.string().unwrapOr("") == "broken");
+
+    auto slow = co_await web::WebRequest().timeout(std::chrono::seconds(1)).get(server->url("/slow"));
+    log::info("Mock slow request timed out: {}", !slow.ok());
+
+    auto chunked = co_await web::WebRequest().get(server->url("/chunked"));
+    log::info("Mock chunked body was joined: {}", chunked.ok() && chunked.string().unwrapOr("") == "first chunk, second chunk, last chunk");
+
+    auto ranged = co_await web::WebRequest().downloadRange({ 2, 5 }).get(server->url("/digits"));
+    log::info("Mock range returned the slice: {}", ranged.code() == 206 && ranged.string().unwrapOr("") == "2345");
+
+    auto redirect = co_await web::WebRequest().get(server->url("/redirect"));
+    log::info("Mock redirect was followed: {}", redirect.ok() && redirect.string().unwrapOr("") == "hello");
+
+    if (auto index = testCacheIndex()) {
+        co_await web::WebRequest().httpCache(true).get(server->url("/cached"));
+        auto wasCached = co_await waitUntilCached(*index, server->url("/cached"));
+        auto cached = co_await web::WebRequest().httpCache(true).get(server->url("/cached"));
+        log::info(
+            "Mock cached response was reused: {}",
+            wasCached && cached.ok() && cached.string().unwrapOr("") == "cached" && server->hits("/cached") == 1
+        );
+
+        co_await web::WebRequest().httpCache(true).get(server->url("/revalidate"));
+        auto stored = co_await waitUntilCached(*index, server->url("/revalidate"));
+        auto revalidated = co_await web::WebRequest().httpCache(true).get(server->url("/revalidate"));
+        log::info(
+            "Mock stale response was revalidated: {}",
+            stored && revalidated.ok() && revalidated.string().unwrapOr("") == "revalidated" &&
+                server->hits("/revalidate") == 2 && server->served("/revalidate") == std::string_view("revalidated").size()
+        );
+
+        // one more than fits in the cache, so the least recently used one has to go
+        auto evictBody = std::string(8 * 1024 * 1024, 'e');
+        bool allStored = true;
+        for (int i = 0; i < 9; i++) {
+            auto path = fmt::format("/evict/{}", i);
+            server->route(path, { .headers = { { "Cache-Control", "max-age=60" } }, .body = evictBody });
+            if (i == 8) {
+                // last-used times are in seconds, so the newest entry mustn't tie with the others
+                co_await arc::sleep(asp::Duration::fromMillis(1100));
+            }
+            co_await web::WebRequest().httpCache(true).get(server->url(path));
+            allStored = co_await waitUntilCached(*index, server->url(path)) && allStored;
+        }
+        log::info("Mock cache was evicted down to its limit: {}", allStored && countCached(*index, server->url("/evict/")) == 8);
+    }
+    else {
+        log::info("Skipping the HTTP cache tests, they need --geode:geode.loader.http-cache-dir");
+    }
+
+    auto form = web::MultipartForm();
+    form.param("name", "geode");
+    form.param("count", 5);
+    form.file("upload", std::span(reinterpret_cast<uint8_t const*>(largeBody.data()), 64 * 1024), "data.bin");
+    auto echoed = co_await web::WebRequest().bodyMultipart(form).post(server->url("/echo"));
+    log::info("Mock multipart body arrived intact: {}", echoed.ok() && echoed.data() == form.getBody());
+
+    auto path = Mod::get()->getSaveDir() / "mock-download.bin";
+    auto downloaded = co_await web::FileDownload().segments(4).download(server->url("/large"), path);
+    auto contents = file::readBinary(path).unwrapOrDefault();
+    log::info("Mock segmented download matches: {}", downloaded.isOk() && std::string(contents.begin(), contents.end()) == largeBody);
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    auto statePath = path;
+    statePath += ".state";
+    auto readDownload = [&] {
+        auto contents = file::readBinary(path).unwrapOrDefault();
+        return std::string(contents.begin(), contents.end());
+    };
+    auto flakyRoute = [&](std::string body, std::string etag, size_t cutAfter) {
+        return MockRoute {
+            .headers = { { "ETag", std::move(etag) } },
+            .body = std::move(body),
+            .ranges = true,
+            .cutAfter = cutAfter,
+        };
+    };
+
+    // every attempt gets cut off, so the download gives up with its progress saved
+    server->route("/flaky", flakyRoute(largeBody, "\"v1\"", 128 * 1024));
+    auto interrupted = co_await web::FileDownload().segments(4).download(server->url("/flaky"), path);
+    log::info("Mock interrupted download kept its state: {}", interrupted.isErr() && std::filesystem::exists(statePath));
+
+    server->route("/flaky", flakyRoute(largeBody, "\"v1\"", 0));
+    auto servedBefore = server->served("/flaky");
+    auto resumed = co_await web::FileDownload().segments(4).download(server->url("/flaky"), path);
+    log::info(
+        "Mock interrupted download resumed: {}",
+        resumed.isOk() && readDownload() == largeBody &&
+            server->served("/flaky") - servedBefore < largeBody.size() &&
+            !std::filesystem::exists(statePath)
+    );
+    std::filesystem::remove(path, ec);
+
+    // the file changed on the server in between, so the parts on disk are useless
+    auto changedBody = std::string(largeBody.rbegin(), largeBody.rend());
+    server->route("/flaky", flakyRoute(largeBody, "\"v1\"", 128 * 1024));
+    co_await web::FileDownload().segments(4).download(server->url("/flaky"), path);
+    server->route("/flaky", flakyRoute(changedBody, "\"v2\"", 0));
+    auto restarted = co_await web::FileDownload().segments(4).download(server->url("/flaky"), path);
+    log::info("Mock changed ETag restarted the download: {}", restarted.isOk() && readDownload() == changedBody);
+    std::filesystem::remove(path, ec);
+
+    auto ignored = co_await web::FileDownload().segments(4).download(server->url("/norange"), path);
+    log::info("Mock download ignoring Range matches: {}", ignored.isOk() && readDownload() == largeBody);
+    std::filesystem::remove(path, ec);
+    std::filesystem::remove(statePath, ec);
+
+    // Benchmarks
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 50; i++) {
+        co_await web::WebRequest().get(server->url("/hello"));
+    }
+    log::info("Mock sequential requests: {:.2f}ms each", millisSince(start) / 50);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<web::WebFuture> requests;
+    for (int i = 0; i < 200; i++) {
+        requests.push_back(web::WebRequest().get(server->url("/hello")));
+    }
+    auto responses = co_await arc::joinAll(std::move(requests));
+    auto succeeded = std::count_if(responses.begin(), responses.end(), [](auto const& res) { return res.ok(); });
+    auto elapsed = millisSince(start);
+    log::info("Mock concurrent requests: {}/200 ok in {:.2f}ms ({:.0f} req/s)", succeeded, elapsed, 200 / (elapsed / 1000));
+
+    start = std::chrono::steady_clock::now();
+    size_t encoded = 0;
+    for (int i = 0; i < 20; i++) {
+        auto form = web::MultipartForm();
+        form.param("name", "geode");
+        form.file("upload", std::span(reinterpret_cast<uint8_t const*>(largeBody.data()), largeBody.size()), "data.bin");
+        encoded += form.getBody().size();
+    }
+    elapsed = millisSince(start);
+    log::info("MultipartForm encoding: {:.2f}ms per form ({:.1f} MiB/s)", elapsed / 20, encoded / (1024.0 * 1024.0) / (elapsed / 1000));
+
+    server->stop();
+}
+
+$on_mod(Loaded) {
+    // this runs a local server, so only do it when asked to with --geode:geode.test.web-tests
+    if (!Mod::get()->getLaunchFlag("web-tests")) {
+        return;
+    }
+
+    auto largeBody = makeTestBody(3 * 1024 * 1024);
+
+    auto server = std::make_shared<MockServer>();
+    server->route("/hello", { .body = "hello" });
+    server->route("/error", { .status = 500, .body = "broken" });
+    server->route("/slow", { .body = "too late", .latency = std::chrono::milliseconds(1500) });
+    server->route("/chunked", { .body = "first chunk, second chunk, last chunk", .chunked = true });
+    server->route("/digits", { .body = "0123456789", .ranges = true });
+    server->route("/redirect", { .status = 302, .headers = { { "Location", "/hello" } } });
+    server->route("/cached", {
+        .headers = { { "Cache-Control", "max-age=60" }, { "ETag", "\"mock\"" } },
+        .body = "cached",
+    });
+    server->route("/revalidate", {
+        .headers = { { "Cache-Control", "no-cache" }, { "ETag", "\"mock\"" } },
+        .body = "revalidated",
+    });
+    server->route("/echo", { .echo = true });
+    server->route("/large", { .body = largeBody, .ranges = true });
+    // claims to support ranges, but always sends the whole body
+    server->route("/norange", { .headers = { { "Accept-Ranges", "bytes" } }, .body = largeBody });
+
+    if (auto res = server->start(); !res) {
+        log::error("Unable to start mock server: {}", res.unwrapErr());
+        return;
+    }
+    async::spawn(runWebTests(std::move(server), std::move(largeBody)));
+}